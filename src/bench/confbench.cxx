@@ -0,0 +1,95 @@
+/*
+ * Compares the Augeas and the native xorg.conf backend on generated
+ * xorg.conf.d trees of 10, 100 and 1000 files.
+ *
+ * usage: sax3-confbench [files...]
+ */
+#include<iostream>
+#include<fstream>
+#include<string>
+#include<vector>
+#include<stdio.h>
+#include<stdlib.h>
+#include<time.h>
+#include<sys/stat.h>
+
+#include "config/configstore.h"
+#include "config/transaction.h"
+
+using namespace std;
+
+static double now(){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC,&ts);
+	return ts.tv_sec*1000.0 + ts.tv_nsec/1000000.0;
+}
+
+static string makeTree(int files){
+	char dir[] = "/tmp/sax3-bench.XXXXXX";
+	if(mkdtemp(dir)==NULL){
+		perror("mkdtemp");
+		exit(1);
+	}
+	string root = dir;
+	mkdir((root+"/etc").c_str(),0755);
+	mkdir((root+"/etc/X11").c_str(),0755);
+	mkdir((root+"/etc/X11/xorg.conf.d").c_str(),0755);
+	for(int i=0;i<files;i++){
+		char name[64];
+		sprintf(name,"/etc/X11/xorg.conf.d/%04d-bench.conf",i);
+		ofstream f((root+name).c_str());
+		f<<"# generated by sax3-confbench\n\n";
+		f<<"Section \"InputClass\"\n";
+		f<<"\tIdentifier \"bench-"<<i<<"\"\n";
+		f<<"\tMatchIsPointer \"on\"\n";
+		f<<"\tDriver \"evdev\"\n";
+		f<<"\tOption \"Emulate3Buttons\" \"on\"\n";
+		f<<"\tOption \"Emulate3Timeout\" \"50\"\n";
+		f<<"\tOption \"InvX\" \"off\"  # keep me\n";
+		f<<"\tOption \"AngleOffset\" \"0\"\n";
+		f<<"EndSection\n\n";
+		f<<"Section \"Device\"\n";
+		f<<"\tIdentifier \"card-"<<i<<"\"\n";
+		f<<"\tDriver \"modesetting\"\n";
+		f<<"EndSection\n";
+	}
+	return root;
+}
+
+static void run(const char * backend,const string &root,int files){
+	double start = now();
+	Conf::ConfigStore store(root.c_str(),backend);
+	double load = now()-start;
+
+	start = now();
+	string file = store.sectionFile("InputClass","MatchIsPointer","/etc/X11/xorg.conf.d/99-bench.conf");
+	double lookup = now()-start;
+
+	Conf::Transaction t(&store);
+	t.beginSection(file,"InputClass");
+	t.set("Identifier","bench-commit");
+	t.option("XkbLayout","de");
+	t.commit();
+
+	printf("%-8s %6d files  load %9.3f ms  lookup %7.3f ms  commit %7.3f ms (%d nodes)\n",
+		backend,files,load,lookup,t.commitMillis(),t.nodesTouched());
+}
+
+int main(int argc,char ** argv){
+	vector<int> sizes;
+	for(int i=1;i<argc;i++)
+		sizes.push_back(atoi(argv[i]));
+	if(sizes.empty()){
+		sizes.push_back(10);
+		sizes.push_back(100);
+		sizes.push_back(1000);
+	}
+	for(unsigned i=0;i<sizes.size();i++){
+		string augeasRoot = makeTree(sizes[i]);
+		string nativeRoot = makeTree(sizes[i]);
+		run("augeas",augeasRoot,sizes[i]);
+		run("native",nativeRoot,sizes[i]);
+		system(("rm -rf "+augeasRoot+" "+nativeRoot).c_str());
+	}
+	return 0;
+}
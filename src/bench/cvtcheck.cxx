@@ -0,0 +1,70 @@
+/*
+ * Compares Display::cvt() and Display::gtf() with what the cvt and gtf
+ * tools print for the same arguments. Each expected line below is the
+ * tools' output verbatim, cvt's Modeline and gtf's without its leading
+ * blanks. Prints every mismatch and exits non-zero if there is one.
+ *
+ * usage: sax3-cvtcheck
+ */
+#include<iostream>
+#include<string>
+#include<stdio.h>
+
+#include "display/cvt.h"
+
+using namespace std;
+
+enum Tool{CVT,CVT_R,GTF};
+
+struct Case{
+	Tool tool;
+	unsigned width,height;
+	double refresh;
+	const char * expected;
+};
+
+static const Case cases[] = {
+	{CVT,800,600,60,"Modeline \"800x600_60.00\"   38.25  800 832 912 1024  600 603 607 624 -hsync +vsync"},
+	{CVT,1024,768,60,"Modeline \"1024x768_60.00\"   63.50  1024 1072 1176 1328  768 771 775 798 -hsync +vsync"},
+	{CVT,1280,720,60,"Modeline \"1280x720_60.00\"   74.50  1280 1344 1472 1664  720 723 728 748 -hsync +vsync"},
+	{CVT,1280,1024,60,"Modeline \"1280x1024_60.00\"  109.00  1280 1368 1496 1712  1024 1027 1034 1063 -hsync +vsync"},
+	{CVT,1366,768,60,"Modeline \"1368x768_60.00\"   85.25  1368 1440 1576 1784  768 771 781 798 -hsync +vsync"},
+	{CVT,1680,1050,60,"Modeline \"1680x1050_60.00\"  146.25  1680 1784 1960 2240  1050 1053 1059 1089 -hsync +vsync"},
+	{CVT,1920,1080,60,"Modeline \"1920x1080_60.00\"  173.00  1920 2048 2248 2576  1080 1083 1088 1120 -hsync +vsync"},
+	{CVT,1920,1080,144,"Modeline \"1920x1080_144.00\"  452.50  1920 2088 2296 2672  1080 1083 1088 1177 -hsync +vsync"},
+	{CVT,2560,1440,60,"Modeline \"2560x1440_60.00\"  312.25  2560 2752 3024 3488  1440 1443 1448 1493 -hsync +vsync"},
+	{CVT,3840,2160,60,"Modeline \"3840x2160_60.00\"  712.75  3840 4160 4576 5312  2160 2163 2168 2237 -hsync +vsync"},
+	{CVT_R,1920,1080,60,"Modeline \"1920x1080R\"  138.50  1920 1968 2000 2080  1080 1083 1088 1111 +hsync -vsync"},
+	{CVT_R,2560,1440,60,"Modeline \"2560x1440R\"  241.50  2560 2608 2640 2720  1440 1443 1448 1481 +hsync -vsync"},
+	{GTF,800,600,60,"Modeline \"800x600_60.00\"  38.22  800 832 912 1024  600 601 604 622  -HSync +Vsync"},
+	{GTF,1024,768,60,"Modeline \"1024x768_60.00\"  64.11  1024 1080 1184 1344  768 769 772 795  -HSync +Vsync"},
+	{GTF,1920,1080,60,"Modeline \"1920x1080_60.00\"  172.80  1920 2040 2248 2576  1080 1081 1084 1118  -HSync +Vsync"},
+};
+
+//The line as the tool that owns the case prints it
+static string line(const Case &c){
+	if(c.tool!=GTF)
+		return "Modeline "+Display::cvt(c.width,c.height,c.refresh,c.tool==CVT_R ? Display::REDUCED : Display::STANDARD).modeline();
+	Display::Timing t = Display::gtf(c.width,c.height,c.refresh);
+	char text[160];
+	snprintf(text,sizeof(text),"Modeline \"%s\"  %.2f  %u %u %u %u  %u %u %u %u  %sHSync %sVsync",t.name.c_str(),t.clock/1000.0,
+		t.hActive,t.hSyncStart,t.hSyncEnd,t.hTotal,t.vActive,t.vSyncStart,t.vSyncEnd,t.vTotal,
+		t.hSyncPositive ? "+" : "-",t.vSyncPositive ? "+" : "-");
+	return text;
+}
+
+int main(){
+	static const char * tools[] = {"cvt","cvt -r","gtf"};
+	unsigned count = sizeof(cases)/sizeof(cases[0]),failed = 0;
+	for(unsigned i=0;i<count;i++){
+		string got = line(cases[i]);
+		if(got==cases[i].expected)
+			continue;
+		failed++;
+		cout<<tools[cases[i].tool]<<" "<<cases[i].width<<" "<<cases[i].height<<" "<<cases[i].refresh<<endl;
+		cout<<"  expected "<<cases[i].expected<<endl;
+		cout<<"  got      "<<got<<endl;
+	}
+	cout<<count-failed<<" of "<<count<<" lines match"<<endl;
+	return failed ? 1 : 0;
+}
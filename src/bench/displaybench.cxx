@@ -0,0 +1,145 @@
+/*
+ * Times Display::Detector on generated sysfs trees of two cards and 1 to 32
+ * connectors, probed by one thread and by the worker pool.
+ *
+ * On real hardware the cost of a connector is the EDID read, a DDC
+ * transfer of 128 or 256 bytes at 100 kHz that takes tens of milliseconds.
+ * Plain files would read in microseconds and hide that, so each edid
+ * attribute here is a FIFO whose writer waits the given latency before
+ * handing over the block.
+ *
+ * usage: sax3-displaybench [latency-ms] [workers]
+ */
+#include<iostream>
+#include<string>
+#include<vector>
+#include<thread>
+#include<stdio.h>
+#include<stdlib.h>
+#include<string.h>
+#include<time.h>
+#include<fcntl.h>
+#include<unistd.h>
+#include<sys/stat.h>
+
+#include "display/detector.h"
+
+using namespace std;
+
+static double now(){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC,&ts);
+	return ts.tv_sec*1000.0 + ts.tv_nsec/1000000.0;
+}
+
+static void writeFile(const string &path,const string &data){
+	FILE * f = fopen(path.c_str(),"w");
+	if(f==NULL){
+		perror(path.c_str());
+		exit(1);
+	}
+	fwrite(data.data(),1,data.size(),f);
+	fclose(f);
+}
+
+/* Base block with the header, a vendor, one 1920x1080 DTD and the checksum */
+static string edidBlock(unsigned serial){
+	unsigned char b[128];
+	memset(b,0,sizeof(b));
+	static const unsigned char header[8] = {0x00,0xff,0xff,0xff,0xff,0xff,0xff,0x00};
+	memcpy(b,header,8);
+	b[8] = 0x10;b[9] = 0xac;
+	b[12] = serial;
+	b[18] = 1;b[19] = 4;
+	static const unsigned char dtd[18] = {0x02,0x3a,0x80,0x18,0x71,0x38,0x2d,0x40,0x58,0x2c,0x45,0x00,0x50,0x1d,0x74,0x00,0x00,0x1e};
+	memcpy(b+0x36,dtd,18);
+	unsigned char sum = 0;
+	for(int i=0;i<127;i++)
+		sum += b[i];
+	b[127] = 0x100-sum;
+	return string((const char*)b,128);
+}
+
+static string makeTree(int connectors,vector<string> &fifos){
+	char dir[] = "/tmp/sax3-displaybench.XXXXXX";
+	if(mkdtemp(dir)==NULL){
+		perror("mkdtemp");
+		exit(1);
+	}
+	string root = dir;
+	string drm = root+"/class/drm";
+	mkdir((root+"/class").c_str(),0755);
+	mkdir(drm.c_str(),0755);
+	for(int c=0;c<2;c++){
+		string card = drm+"/card"+to_string(c);
+		mkdir(card.c_str(),0755);
+		mkdir((card+"/device").c_str(),0755);
+		writeFile(card+"/device/vendor",c==0 ? "0x8086\n" : "0x1002\n");
+		writeFile(card+"/device/device","0x1234\n");
+		writeFile(card+"/device/boot_vga",c==0 ? "1\n" : "0\n");
+		writeFile(card+"/device/uevent",string("DRIVER=")+(c==0 ? "i915" : "amdgpu")+"\nPCI_SLOT_NAME=0000:0"+to_string(c)+":00.0\n");
+	}
+	for(int i=0;i<connectors;i++){
+		string dir = drm+"/card"+to_string(i%2)+"-DP-"+to_string(i/2+1);
+		mkdir(dir.c_str(),0755);
+		writeFile(dir+"/status","connected\n");
+		writeFile(dir+"/enabled","enabled\n");
+		writeFile(dir+"/modes","1920x1080\n1280x720\n");
+		string edid = dir+"/edid";
+		if(mkfifo(edid.c_str(),0644)==-1){
+			perror("mkfifo");
+			exit(1);
+		}
+		fifos.push_back(edid);
+	}
+	return root;
+}
+
+/* One writer per FIFO, waiting for the detector to open it */
+static double probe(const string &root,const vector<string> &fifos,unsigned workers,int latency){
+	vector<thread> writers;
+	for(unsigned i=0;i<fifos.size();i++){
+		writers.push_back(thread([&fifos,i,latency](){
+			int fd = open(fifos[i].c_str(),O_WRONLY);
+			if(fd==-1)
+				return;
+			usleep(latency*1000);
+			string block = edidBlock(i);
+			if(write(fd,block.data(),block.size())!=(ssize_t)block.size())
+				perror("write");
+			close(fd);
+		}));
+	}
+	Display::Detector detector(root.c_str(),workers);
+	double start = now();
+	detector.scan();
+	double ms = now()-start;
+	for(unsigned i=0;i<writers.size();i++)
+		writers[i].join();
+	if(detector.topology().connectedCount()!=fifos.size())
+		cerr<<"expected "<<fifos.size()<<" connected outputs, got "<<detector.topology().connectedCount()<<endl;
+	return ms;
+}
+
+int main(int argc,char ** argv){
+	int latency = argc>1 ? atoi(argv[1]) : 20;
+	unsigned workers = argc>2 ? atoi(argv[2]) : 8;
+	static const int sizes[] = {1,2,4,6,8,16,32};
+	vector<string> rows;
+	for(unsigned s=0;s<sizeof(sizes)/sizeof(sizes[0]);s++){
+		vector<string> fifos;
+		string root = makeTree(sizes[s],fifos);
+		double serial = probe(root,fifos,1,latency);
+		double pooled = probe(root,fifos,workers,latency);
+		char line[128];
+		snprintf(line,sizeof(line),"%3d connectors  %9.2f ms on 1 thread  %9.2f ms on up to %u",sizes[s],serial,pooled,workers);
+		rows.push_back(line);
+		string cmd = "rm -rf "+root;
+		if(system(cmd.c_str())!=0)
+			cerr<<"Cannot remove "<<root<<endl;
+	}
+	cout<<endl<<latency<<" ms per EDID read"<<endl;
+	for(unsigned i=0;i<rows.size();i++)
+		cout<<rows[i]<<endl;
+	return 0;
+}
@@ -0,0 +1,211 @@
+/*
+ * Compares the XKB rules catalogue with the std::map layout the keyboard
+ * module used to build from base.lst: resident memory, heap allocations and
+ * time to reach a state where every description can be listed. The mapped
+ * cache itself is file backed and shared, it shows up as its file size. Each case
+ * runs in its own process so the heap of one does not flatter the other.
+ *
+ * It also times type-ahead queries against the search index built over the
+ * whole catalogue, and the streaming evdev.xml pass behind the locale
+ * suggestions against the base.lst compile.
+ *
+ * usage: sax3-xkbbench [base.lst]
+ */
+#include<iostream>
+#include<fstream>
+#include<map>
+#include<new>
+#include<string>
+#include<vector>
+#include<utility>
+#include<stdio.h>
+#include<stdlib.h>
+#include<string.h>
+#include<time.h>
+#include<unistd.h>
+#include<sys/stat.h>
+#include<sys/wait.h>
+
+#include "xkb/catalogue.h"
+#include "xkb/search.h"
+#include "xkb/localeindex.h"
+
+using namespace std;
+
+static size_t allocations = 0;
+
+void * operator new(size_t n){
+	++allocations;
+	void * p = malloc(n ? n : 1);
+	if(p==NULL)
+		throw bad_alloc();
+	return p;
+}
+
+void operator delete(void * p) noexcept{
+	free(p);
+}
+
+void operator delete(void * p,size_t) noexcept{
+	free(p);
+}
+
+static double now(){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC,&ts);
+	return ts.tv_sec*1000.0 + ts.tv_nsec/1000000.0;
+}
+
+/* Private resident memory, the heap and touched private mappings. Shared
+ * code paged in on first use would drown the difference otherwise. */
+static long rssKb(){
+	long kb = 0;
+	char line[128];
+	FILE * f = fopen("/proc/self/status","r");
+	if(f==NULL)
+		return 0;
+	while(fgets(line,sizeof(line),f)!=NULL)
+		if(!strncmp(line,"RssAnon:",8))
+			kb = atol(line+8);
+	fclose(f);
+	return kb;
+}
+
+static void report(const char * name,double ms,size_t allocs,long rss,size_t chars){
+	printf("%-16s %9.3f ms  %7zu allocations  %6ld kB anonymous RSS  (%zu chars listed)\n",name,ms,allocs,rss,chars);
+	fflush(stdout);
+}
+
+/* The loop keyboard::keyboard() ran before the catalogue, minus its output. */
+static void maps(const char * rules){
+	map<string,string> layout,model,variant;
+	vector< pair<string,string> > options;
+	long rss = rssKb();
+	size_t allocs = allocations;
+	double start = now();
+	ifstream baseFile(rules,ios::in);
+	string line,s1;
+	int type = 0;
+	while(baseFile.good()){
+		getline(baseFile,line);
+		line.erase(0,2);
+		if(!line.compare("model")){type = 0;continue;}
+		if(!line.compare("layout")){type = 1;continue;}
+		if(!line.compare("variant")){type = 2;continue;}
+		if(!line.compare("option")){type = 3;continue;}
+		int pos = line.find_first_of(' ');
+		s1 = line.substr(0,pos);line.erase(0,pos);
+		pos = line.find_first_of("abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ");
+		line.erase(0,pos-1);
+		if(line.length()==0)
+			continue;
+		if(type==0) model[line]=s1;
+		if(type==1) layout[line]=s1;
+		if(type==2) variant[line]=s1;
+		if(type==3) options.push_back(make_pair(line,s1));
+	}
+	size_t chars = 0;
+	map<string,string> * all[] = {&model,&layout,&variant};
+	for(int k=0;k<3;k++)
+		for(map<string,string>::iterator it=all[k]->begin();it!=all[k]->end();it++)
+			chars += it->first.size();
+	for(unsigned i=0;i<options.size();i++)
+		chars += options[i].first.size();
+	report("std::map",now()-start,allocations-allocs,rssKb()-rss,chars);
+}
+
+static void catalogue(const char * name,const char * rules,const char * cache){
+	cout<<flush;
+	long rss = rssKb();
+	size_t allocs = allocations;
+	double start = now();
+	XKB::Catalogue c(rules,cache);
+	c.complete();
+	size_t chars = 0;
+	for(int k=0;k<XKB::KINDS;k++)
+		for(unsigned i=0;i<c.count((XKB::Kind)k);i++)
+			chars += strlen(c.description((XKB::Kind)k,i));
+	report(name,now()-start,allocations-allocs,rssKb()-rss,chars);
+}
+
+static void searches(const char *,const char * rules,const char * cache){
+	const char * queries[] = {"d","de","German","nodeadkeys","caps:escape","Caps Lock","germn","compose"};
+	const int rounds = 200;
+	XKB::Catalogue c(rules,cache);
+	c.complete();
+	double start = now();
+	XKB::Search search(&c);
+	printf("search index     %9.3f ms to build\n",now()-start);
+	vector<XKB::Match> hits;
+	for(unsigned q=0;q<sizeof(queries)/sizeof(queries[0]);q++){
+		double worst = 0;
+		start = now();
+		for(int r=0;r<rounds;r++){
+			double t = now();
+			search.find(queries[q],hits);
+			t = now()-t;
+			if(t>worst)
+				worst = t;
+		}
+		printf("  %-14s %4zu hits  %7.1f us avg  %7.1f us worst\n",queries[q],hits.size(),
+			(now()-start)*1000/rounds,worst*1000);
+	}
+	fflush(stdout);
+}
+
+static void xml(const char * name,const char *,const char *){
+	long rss = rssKb();
+	size_t allocs = allocations;
+	double start = now();
+	XKB::LocaleIndex index;
+	index.load();
+	vector<XKB::LayoutRef> likely;
+	index.suggest("de_DE.UTF-8",likely);
+	printf("%-16s %9.3f ms  %7zu allocations  %6ld kB anonymous RSS  (%zu languages, %zu countries)\n",
+		name,now()-start,allocations-allocs,rssKb()-rss,index.languageCount(),index.countryCount());
+	fflush(stdout);
+}
+
+/* What simple mode waits for on a cold cache. */
+static void layouts(const char * name,const char * rules,const char * cache){
+	double start = now();
+	XKB::Catalogue c(rules,cache);
+	size_t chars = 0;
+	for(unsigned i=0;i<c.count(XKB::LAYOUT);i++)
+		chars += strlen(c.description(XKB::LAYOUT,i));
+	printf("%-16s %9.3f ms  (%zu chars listed)\n",name,now()-start,chars);
+	fflush(stdout);
+}
+
+static void isolated(void (*run)(const char *,const char *,const char *),const char * name,const char * rules,const char * cache){
+	pid_t pid = fork();
+	if(pid==0){
+		run(name,rules,cache);
+		_exit(0);
+	}
+	waitpid(pid,NULL,0);
+}
+
+static void mapsCase(const char *,const char * rules,const char *){
+	maps(rules);
+}
+
+int main(int argc,char ** argv){
+	const char * rules = argc>1 ? argv[1] : "/usr/share/X11/xkb/rules/base.lst";
+	char dir[] = "/tmp/sax3-xkbbench.XXXXXX";
+	if(mkdtemp(dir)==NULL){
+		perror("mkdtemp");
+		return 1;
+	}
+	isolated(mapsCase,"std::map",rules,dir);
+	isolated(layouts,"layouts only",rules,dir);
+	isolated(catalogue,"catalogue cold",rules,dir);
+	isolated(catalogue,"catalogue warm",rules,dir);
+	isolated(searches,"search",rules,dir);
+	isolated(xml,"evdev.xml stream",rules,dir);
+	struct stat st;
+	if(stat((string(dir)+"/xkb-rules.cache").c_str(),&st)==0)
+		printf("cache image      %ld kB mapped\n",(long)(st.st_size+1023)/1024);
+	system((string("rm -rf ")+dir).c_str());
+	return 0;
+}
@@ -0,0 +1,279 @@
+#include "augeasbackend.h"
+
+#include<iostream>
+#include<stdio.h>
+#include<stdlib.h>
+#include<strings.h>
+
+#define LOG_TAG "[SaX3-Conf]"
+
+using namespace std;
+
+namespace Conf{
+
+	static string get(augeas * aug,const string &path){
+		const char * value = NULL;
+		if(aug_get(aug,path.c_str(),&value)!=1 || value==NULL)
+			return "";
+		return value;
+	}
+
+	static string label(augeas * aug,const char * path){
+		const char * l = NULL;
+		if(aug_label(aug,path,&l)!=1 || l==NULL)
+			return "";
+		return l;
+	}
+
+	static void freeMatches(char ** m,int cnt){
+		for(int i=0;i<cnt;i++)
+			free(m[i]);
+		if(cnt>0)
+			free(m);
+	}
+
+	/* Keywords with a handler of their own in the Xorg lens, which takes
+	 * their quotes off. Every other keyword is stored verbatim, quotes
+	 * included. */
+	static bool lensUnquotes(const string &key){
+		static const char * handled[] = {"Identifier","Driver","Device","Monitor","Screen","InputDevice",
+			"MatchProduct","MatchVendor","MatchIsPointer","MatchIsTouchpad","Modes","Visual","Options",NULL};
+		for(int i=0;handled[i]!=NULL;i++)
+			if(!strcasecmp(key.c_str(),handled[i]))
+				return true;
+		return false;
+	}
+
+	//Value of a verbatim entry without the quotes around a single string
+	static string unquote(const string &value){
+		if(value.size()>=2 && value[0]=='"' && value[value.size()-1]=='"' && value.find('"',1)==value.size()-1)
+			return value.substr(1,value.size()-2);
+		return value;
+	}
+
+	static string quote(const string &key,const string &value){
+		return quotedKeyword(key) && !lensUnquotes(key) ? "\""+value+"\"" : value;
+	}
+
+	/* Display entries the lens splits into one child per number, such as
+	 * Virtual into x and y. NULL for entries with a value of their own. */
+	static const char * const * fieldsOf(const string &key){
+		static const char * xy[] = {"x","y",NULL};
+		static const char * rgb[] = {"red","green","blue",NULL};
+		if(!strcasecmp(key.c_str(),"Virtual") || !strcasecmp(key.c_str(),"ViewPort"))
+			return xy;
+		if(!strcasecmp(key.c_str(),"Weight") || !strcasecmp(key.c_str(),"Black") || !strcasecmp(key.c_str(),"White"))
+			return rgb;
+		return NULL;
+	}
+
+	//One number of a space separated value into each field
+	static bool setFields(augeas * aug,const string &path,const char * const * fields,const string &value){
+		size_t pos = 0;
+		for(int f=0;fields[f]!=NULL;f++){
+			size_t begin = value.find_first_not_of(' ',pos);
+			if(begin==string::npos)
+				return false;
+			pos = value.find(' ',begin);
+			string number = value.substr(begin,pos==string::npos ? string::npos : pos-begin);
+			if(aug_set(aug,(path+"/"+fields[f]).c_str(),number.c_str())==-1)
+				return false;
+		}
+		return true;
+	}
+
+	AugeasBackend::AugeasBackend(const char * r) : Backend(r){
+		files=0;
+		aug = aug_init(r,SAX3_LENS_DIR,AUG_NO_LOAD|AUG_NO_MODL_AUTOLOAD);
+	}
+
+	const char * AugeasBackend::name(){
+		return "augeas";
+	}
+
+	bool AugeasBackend::load(){
+		if(aug==NULL){
+			cout<<LOG_TAG<<" AUGEAS NOT LOADED"<<endl;
+			return false;
+		}
+		aug_set(aug,"/augeas/load/Xorg/lens","Xorg.lns");
+		aug_set(aug,"/augeas/load/Xorg/incl[last()+1]","/etc/X11/xorg.conf");
+		aug_set(aug,"/augeas/load/Xorg/incl[last()+1]","/etc/X11/xorg.conf.d/*.conf");
+		if(aug_load(aug)==-1){
+			cout<<LOG_TAG<<" Xorg lens failed to load"<<endl;
+			aug_print(aug,stdout,"/augeas//error");
+			return false;
+		}
+		files = aug_match(aug,"/augeas/files//path",NULL);
+		if(files<0)
+			files=0;
+		return true;
+	}
+
+	int AugeasBackend::fileCount(){
+		return files;
+	}
+
+	void AugeasBackend::readSection(const char * path,vector<Section> &list){
+		string type = label(aug,path);
+		if(type.empty() || type[0]=='#')
+			return;
+		Section s;
+		s.path = path;
+		s.type = type;
+		s.file = s.path.substr(6,s.path.rfind('/')-6);
+		/* aug_match leaves out [1] on a lone node, spell it out so paths
+		 * stay valid once a second section of the type is added */
+		if(s.path[s.path.size()-1]!=']')
+			s.path.append("[1]");
+		char **children;
+		int cnt = aug_match(aug,(s.path+"/*").c_str(),&children);
+		for(int i=0;i<cnt;i++){
+			string key = label(aug,children[i]);
+			if(key.empty() || key[0]=='#')
+				continue;
+			if(key=="Option"){
+				s.entries.push_back(Entry(Entry::OPTION,get(aug,children[i]),get(aug,string(children[i])+"/value[1]")));
+			}else if(key=="Display"){
+				char **display;
+				int n = aug_match(aug,(string(children[i])+"/*").c_str(),&display);
+				for(int j=0;j<n;j++){
+					string k = label(aug,display[j]);
+					if(k.empty() || k[0]=='#')
+						continue;
+					const char * const * fields = fieldsOf(k);
+					string value;
+					for(int f=0;fields!=NULL && fields[f]!=NULL;f++){
+						if(f>0)
+							value += " ";
+						value += get(aug,string(display[j])+"/"+fields[f]);
+					}
+					s.entries.push_back(Entry(Entry::DISPLAY,k,fields==NULL ? get(aug,display[j]) : value));
+				}
+				freeMatches(display,n);
+			}else{
+				string value = get(aug,children[i]);
+				s.entries.push_back(Entry(Entry::PLAIN,key,lensUnquotes(key) ? value : unquote(value)));
+			}
+		}
+		freeMatches(children,cnt);
+		list.push_back(s);
+	}
+
+	void AugeasBackend::sections(vector<Section> &list){
+		const char * patterns[] = {"/files/etc/X11/xorg.conf/*","/files/etc/X11/xorg.conf.d/*/*"};
+		for(int p=0;p<2;p++){
+			char **match;
+			int cnt = aug_match(aug,patterns[p],&match);
+			for(int i=0;i<cnt;i++)
+				readSection(match[i],list);
+			freeMatches(match,cnt);
+		}
+	}
+
+	bool AugeasBackend::commit(vector<SectionEdit> &edits,int &touched){
+		if(aug==NULL)
+			return false;
+		char **saved;
+		vector<string> targets;
+		aug_set(aug,"/augeas/save","newfile");
+		if(!apply(edits,touched) || aug_save(aug)==-1){
+			aug_print(aug,stdout,"/augeas//error");
+			aug_load(aug);
+			return false;
+		}
+		int cnt = aug_match(aug,"/augeas/events/saved",&saved);
+		for(int i=0;i<cnt;i++){
+			string file = get(aug,saved[i]);
+			if(!file.empty())
+				targets.push_back(root+file.substr(6));
+		}
+		freeMatches(saved,cnt);
+		if(!install(targets)){
+			aug_load(aug);
+			return false;
+		}
+		return true;
+	}
+
+	//Path of the first node matching expr, or of a new one if there is none
+	static string firstOrNew(augeas * aug,const string &expr,const string &append){
+		return aug_match(aug,expr.c_str(),NULL)>0 ? expr+"[1]" : expr+append;
+	}
+
+	bool AugeasBackend::apply(vector<SectionEdit> &edits,int &touched){
+		int created;
+		for(unsigned i=0;i<edits.size();i++){
+			bool update = !edits[i].path.empty();
+			if(update){
+				if(aug_defvar(aug,"sec",edits[i].path.c_str())<=0)
+					return false;
+			}else{
+				string section = "/files"+edits[i].file+"/"+edits[i].type+"[last()+1]";
+				if(aug_defnode(aug,"sec",section.c_str(),NULL,&created)==-1)
+					return false;
+				++touched;
+			}
+			bool hasDisplay = false;
+			vector<Entry> &entries = edits[i].entries;
+			for(unsigned j=0;j<entries.size();j++){
+				string path;
+				if(entries[j].remove){
+					string expr = entries[j].kind==Entry::OPTION ? "$sec/Option[.=\""+entries[j].key+"\"]"
+						: entries[j].kind==Entry::DISPLAY ? "$sec/Display/"+entries[j].key : "$sec/"+entries[j].key;
+					if(aug_rm(aug,expr.c_str())==-1)
+						return false;
+					++touched;
+					continue;
+				}
+				switch(entries[j].kind){
+				case Entry::OPTION:{
+					string option = "$sec/Option[.=\""+entries[j].key+"\"]";
+					if(update && aug_match(aug,option.c_str(),NULL)>0){
+						if(aug_defvar(aug,"opt",(option+"[1]").c_str())<=0)
+							return false;
+						path = firstOrNew(aug,"$opt/value","");
+					}else{
+						if(aug_defnode(aug,"opt","$sec/Option[last()+1]",entries[j].key.c_str(),&created)==-1)
+							return false;
+						++touched;
+						path = "$opt/value";
+					}
+					break;
+				}
+				case Entry::DISPLAY:
+					if(!hasDisplay){
+						string display = update ? firstOrNew(aug,"$sec/Display","[last()+1]") : "$sec/Display[last()+1]";
+						if(aug_defnode(aug,"disp",display.c_str(),NULL,&created)==-1)
+							return false;
+						touched+=created;
+						hasDisplay = true;
+					}
+					path = firstOrNew(aug,"$disp/"+entries[j].key,"");
+					if(fieldsOf(entries[j].key)!=NULL){
+						if(!setFields(aug,path,fieldsOf(entries[j].key),entries[j].value))
+							return false;
+						++touched;
+						continue;
+					}
+					break;
+				default:
+					if(entries[j].multi)
+						path = "$sec/"+entries[j].key+"[last()+1]";
+					else
+						path = update ? firstOrNew(aug,"$sec/"+entries[j].key,"") : "$sec/"+entries[j].key;
+				}
+				string value = entries[j].kind==Entry::PLAIN ? quote(entries[j].key,entries[j].value) : entries[j].value;
+				if(aug_set(aug,path.c_str(),value.c_str())==-1)
+					return false;
+				++touched;
+			}
+		}
+		return true;
+	}
+
+	AugeasBackend::~AugeasBackend(){
+		if(aug!=NULL)
+			aug_close(aug);
+	}
+}
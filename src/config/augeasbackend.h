@@ -0,0 +1,39 @@
+#ifndef AUGEASBACKEND_H_
+#define AUGEASBACKEND_H_
+
+extern "C"{
+#include<augeas.h>
+}
+
+#include "backend.h"
+
+#ifndef SAX3_LENS_DIR
+#define SAX3_LENS_DIR "/usr/share/sax3/lenses"
+#endif
+
+namespace Conf{
+
+/*! \class AugeasBackend
+    \brief Backend using the bundled Xorg lens
+
+    Augeas is started with AUG_NO_LOAD and AUG_NO_MODL_AUTOLOAD so that no lens
+    is compiled and no file is parsed behind our back. Only the Xorg lens is
+    registered, restricted to /etc/X11/xorg.conf and the xorg.conf.d snippets.
+    */
+	class AugeasBackend : public Backend{
+		augeas * aug;
+		int files;
+		void readSection(const char * path,std::vector<Section> &list);
+		bool apply(std::vector<SectionEdit> &edits,int &touched);
+		public:
+		AugeasBackend(const char * root);
+		const char * name();
+		bool load();
+		int fileCount();
+		void sections(std::vector<Section> &list);
+		bool commit(std::vector<SectionEdit> &edits,int &touched);
+		~AugeasBackend();
+	};
+}
+
+#endif
@@ -0,0 +1,78 @@
+#include "backend.h"
+#include "augeasbackend.h"
+#include "nativebackend.h"
+
+#include<iostream>
+#include<stdio.h>
+#include<string.h>
+#include<strings.h>
+#include<fcntl.h>
+#include<unistd.h>
+
+#define LOG_TAG "[SaX3-Conf]"
+
+using namespace std;
+
+namespace Conf{
+
+	Backend::Backend(const char * r){
+		root = (r==NULL) ? "" : r;
+		if(root.size() && root[root.size()-1]=='/')
+			root.erase(root.size()-1);
+	}
+
+	/* Every target has its new content waiting in <target>.augnew. Make it
+	 * durable and move it into place; originals are kept as hard links until
+	 * every rename went through so a failure leaves all files untouched. */
+	bool Backend::install(const vector<string> &targets){
+		bool ok = true;
+		for(unsigned i=0;i<targets.size() && ok;i++){
+			string tmp = targets[i]+".augnew";
+			int fd = open(tmp.c_str(),O_RDONLY);
+			if(fd==-1 || fsync(fd)==-1)
+				ok = false;
+			if(fd!=-1)
+				close(fd);
+		}
+		unsigned done=0;
+		for(;ok && done<targets.size();done++){
+			string tmp = targets[done]+".augnew",bak = targets[done]+".saxbak";
+			unlink(bak.c_str());
+			link(targets[done].c_str(),bak.c_str());
+			if(rename(tmp.c_str(),targets[done].c_str())==-1){
+				cout<<LOG_TAG<<" Cannot replace "<<targets[done]<<endl;
+				ok = false;
+				break;
+			}
+		}
+		for(unsigned i=0;i<targets.size();i++){
+			string tmp = targets[i]+".augnew",bak = targets[i]+".saxbak";
+			if(!ok && i<done){
+				if(access(bak.c_str(),F_OK)==0)
+					rename(bak.c_str(),targets[i].c_str());
+				else
+					unlink(targets[i].c_str());
+			}
+			unlink(bak.c_str());
+			unlink(tmp.c_str());
+		}
+		return ok;
+	}
+
+	bool quotedKeyword(const string &key){
+		static const char * quoted[] = {"Identifier","Driver","Device","Monitor","Screen","InputDevice",
+			"Modes","Visual","Options","Inactive","BusID",NULL};
+		if(!strncasecmp(key.c_str(),"Match",5))
+			return true;
+		for(int i=0;quoted[i]!=NULL;i++)
+			if(!strcasecmp(key.c_str(),quoted[i]))
+				return true;
+		return false;
+	}
+
+	Backend * createBackend(const char * name,const char * root){
+		if(name!=NULL && !strcmp(name,"native"))
+			return new NativeBackend(root);
+		return new AugeasBackend(root);
+	}
+}
@@ -0,0 +1,37 @@
+#ifndef BACKEND_H_
+#define BACKEND_H_
+
+#include "section.h"
+
+#include<string>
+#include<vector>
+
+namespace Conf{
+
+/*! \class Backend
+    \brief Storage behind ConfigStore
+
+    A backend parses /etc/X11/xorg.conf and the xorg.conf.d snippets below its
+    root, hands out the sections it found and writes queued edits back.
+    */
+	class Backend{
+		protected:
+		std::string root;
+		bool install(const std::vector<std::string> &targets);
+		public:
+		Backend(const char * r);
+		virtual const char * name()=0;
+		virtual bool load()=0;
+		virtual int fileCount()=0;
+		virtual void sections(std::vector<Section> &list)=0;
+		virtual bool commit(std::vector<SectionEdit> &edits,int &touched)=0;
+		virtual ~Backend(){}
+	};
+
+	/* Keywords whose argument Xorg expects as a quoted string, Match* included */
+	bool quotedKeyword(const std::string &key);
+
+	Backend * createBackend(const char * name,const char * root);
+}
+
+#endif
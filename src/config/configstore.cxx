@@ -0,0 +1,217 @@
+#include "configstore.h"
+
+#include<iostream>
+#include<time.h>
+#include<stdio.h>
+#include<stdlib.h>
+
+#define LOG_TAG "[SaX3-Conf]"
+
+using namespace std;
+
+namespace Conf{
+
+	static double now(){
+		struct timespec ts;
+		clock_gettime(CLOCK_MONOTONIC,&ts);
+		return ts.tv_sec*1000.0 + ts.tv_nsec/1000000.0;
+	}
+
+	ConfigStore::ConfigStore(const char * root,const char * backendName){
+		if(root==NULL)
+			root = getenv("AUGEAS_ROOT");
+		if(backendName==NULL)
+			backendName = getenv("SAX3_CONF_BACKEND");
+		double start = now();
+		backend = createBackend(backendName,root);
+		loaded = backend->load();
+		if(loaded)
+			refresh();
+		loadTime = now()-start;
+		cout<<LOG_TAG<<" ["<<backend->name()<<"] Parsed "<<backend->fileCount()<<" file(s) in "<<loadTime<<" ms"<<endl;
+	}
+
+	void ConfigStore::refresh(){
+		tree.clear();
+		backend->sections(tree);
+		lookup.build(tree);
+	}
+
+	bool ConfigStore::isLoaded(){
+		return loaded;
+	}
+
+	const char * ConfigStore::backendName(){
+		return backend->name();
+	}
+
+	int ConfigStore::fileCount(){
+		return backend->fileCount();
+	}
+
+	double ConfigStore::loadMillis(){
+		return loadTime;
+	}
+
+	const vector<Section> & ConfigStore::sections(){
+		return tree;
+	}
+
+	const SectionIndex & ConfigStore::index(){
+		return lookup;
+	}
+
+	string ConfigStore::sectionFile(const string &type,const string &entry,const string &fallback){
+		string last = lookup.lastFile(type,entry);
+		return last.empty() ? fallback : last;
+	}
+
+	/* The last section of type whose Match* entry has the given value, -1
+	 * when there is none */
+	int ConfigStore::lastMatching(const string &type,const string &matchKey,const string &matchValue){
+		vector<int> ids = lookup.matching(matchKey,matchValue);
+		int last = -1;
+		for(unsigned i=0;i<ids.size();i++)
+			if(tree[ids[i]].type==type && ids[i]>last)
+				last = ids[i];
+		return last;
+	}
+
+	/* File of the last drop-in section matching the same devices, else of
+	 * the last one carrying the key at all */
+	string ConfigStore::sectionFile(const string &type,const string &matchKey,const string &matchValue,const string &fallback){
+		vector<int> ids = lookup.matching(matchKey,matchValue);
+		string last;
+		for(unsigned i=0;i<ids.size();i++){
+			const Section &s = tree[ids[i]];
+			if(s.type==type && !s.file.compare(0,21,"/etc/X11/xorg.conf.d/") && last<s.file)
+				last = s.file;
+		}
+		return last.empty() ? sectionFile(type,matchKey,fallback) : last;
+	}
+
+	const Section * ConfigStore::findSection(const string &type,const string &identifier){
+		int id = lookup.byIdentifier(type,identifier);
+		return id<0 ? NULL : &tree[id];
+	}
+
+	/* Turn edits of sections that already exist into in-place updates carrying
+	 * only what differs from the file. An edit left empty is dropped. */
+	void ConfigStore::resolve(vector<SectionEdit> &edits){
+		vector<SectionEdit>::iterator it = edits.begin();
+		while(it!=edits.end()){
+			if(it->identifier.empty()){
+				++it;
+				continue;
+			}
+			const Section * s = findSection(it->type,it->identifier);
+			if(s==NULL){
+				it->entries.insert(it->entries.begin(),Entry(Entry::PLAIN,"Identifier",it->identifier));
+				++it;
+				continue;
+			}
+			it->path = s->path;
+			it->file = s->file;
+			vector<Entry> changed;
+			for(unsigned i=0;i<it->entries.size();i++){
+				const Entry &e = it->entries[i];
+				if(e.multi){
+					/* a removal and the appends after it stand for the whole
+					 * list, kept only when the list differs from the file */
+					unsigned end = i+1;
+					while(end<it->entries.size() && it->entries[end].multi && !it->entries[end].remove && it->entries[end].key==e.key)
+						end++;
+					vector<string> current,wanted;
+					for(unsigned j=0;j<s->entries.size();j++)
+						if(s->entries[j].kind==e.kind && s->entries[j].key==e.key)
+							current.push_back(s->entries[j].value);
+					for(unsigned j=i+1;j<end;j++)
+						wanted.push_back(it->entries[j].value);
+					if(current!=wanted)
+						changed.insert(changed.end(),it->entries.begin()+i,it->entries.begin()+end);
+					i = end-1;
+					continue;
+				}
+				const Entry * current = s->find(e.kind,e.key);
+				if(e.remove ? current!=NULL : (current==NULL || current->value!=e.value))
+					changed.push_back(e);
+			}
+			it->entries.swap(changed);
+			if(it->entries.empty())
+				it = edits.erase(it);
+			else
+				++it;
+		}
+	}
+
+	bool ConfigStore::commit(vector<SectionEdit> &edits,int &touched){
+		if(!loaded)
+			return false;
+		resolve(edits);
+		if(edits.empty())
+			return true;
+		if(!backend->commit(edits,touched))
+			return false;
+		apply(edits);
+		return true;
+	}
+
+	/* Mirror a committed batch into the snapshot. New sections are appended
+	 * under the path the backends give the next section of that type. */
+	void ConfigStore::apply(const vector<SectionEdit> &edits){
+		for(unsigned i=0;i<edits.size();i++){
+			const SectionEdit &edit = edits[i];
+			int id = edit.path.empty() ? -1 : lookup.byIdentifier(edit.type,edit.identifier);
+			if(id<0){
+				int n=1;
+				const vector<int> &same = lookup.byType(edit.type);
+				for(unsigned j=0;j<same.size();j++)
+					if(tree[same[j]].file==edit.file)
+						n++;
+				char idx[16];
+				sprintf(idx,"[%d]",n);
+				Section s;
+				s.file = edit.file;
+				s.type = edit.type;
+				s.path = "/files"+edit.file+"/"+edit.type+idx;
+				for(unsigned j=0;j<edit.entries.size();j++)
+					if(!edit.entries[j].remove)
+						s.entries.push_back(edit.entries[j]);
+				tree.push_back(s);
+				lookup.add(tree.size()-1);
+				continue;
+			}
+			vector<Entry> &entries = tree[id].entries;
+			for(unsigned j=0;j<edit.entries.size();j++){
+				const Entry &e = edit.entries[j];
+				if(e.multi){
+					for(unsigned k=0;e.remove && k<entries.size();){
+						if(entries[k].kind==e.kind && entries[k].key==e.key)
+							entries.erase(entries.begin()+k);
+						else
+							k++;
+					}
+					if(!e.remove)
+						entries.push_back(Entry(e.kind,e.key,e.value));
+					continue;
+				}
+				vector<Entry>::iterator it = entries.begin();
+				while(it!=entries.end() && (it->kind!=e.kind || it->key!=e.key))
+					++it;
+				if(e.remove){
+					if(it!=entries.end())
+						entries.erase(it);
+				}
+				else if(it!=entries.end())
+					it->value = e.value;
+				else
+					entries.push_back(Entry(e.kind,e.key,e.value));
+			}
+			lookup.update(id);
+		}
+	}
+
+	ConfigStore::~ConfigStore(){
+		delete backend;
+	}
+}
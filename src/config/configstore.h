@@ -0,0 +1,48 @@
+#ifndef CONFIGSTORE_H_
+#define CONFIGSTORE_H_
+
+#include "backend.h"
+#include "section.h"
+#include "sectionindex.h"
+
+#include<string>
+#include<vector>
+
+namespace Conf{
+
+/*! \class ConfigStore
+    \brief Shared xorg.conf access for all SaX3 modules
+
+    Loads the configuration once through a Backend and keeps a snapshot of its
+    sections for the modules to read. The backend is "augeas" (bundled Xorg lens)
+    unless "native" is requested explicitly or through SAX3_CONF_BACKEND.
+    Lookups go through a SectionIndex built at load time; commits patch the
+    snapshot and the index in place rather than reading everything back.
+    */
+	class ConfigStore{
+		Backend * backend;
+		std::vector<Section> tree;
+		SectionIndex lookup;
+		bool loaded;
+		double loadTime;
+		void refresh();
+		void resolve(std::vector<SectionEdit> &edits);
+		void apply(const std::vector<SectionEdit> &edits);
+		public:
+		ConfigStore(const char * root=NULL,const char * backendName=NULL);
+		bool isLoaded();
+		const char * backendName();
+		int fileCount();
+		double loadMillis();
+		const std::vector<Section> & sections();
+		const SectionIndex & index();
+		const Section * findSection(const std::string &type,const std::string &identifier);
+		std::string sectionFile(const std::string &type,const std::string &entry,const std::string &fallback);
+		std::string sectionFile(const std::string &type,const std::string &matchKey,const std::string &matchValue,const std::string &fallback);
+		int lastMatching(const std::string &type,const std::string &matchKey,const std::string &matchValue);
+		bool commit(std::vector<SectionEdit> &edits,int &touched);
+		~ConfigStore();
+	};
+}
+
+#endif
@@ -0,0 +1,419 @@
+#include "nativebackend.h"
+
+#include<iostream>
+#include<algorithm>
+#include<map>
+#include<stdio.h>
+#include<string.h>
+#include<strings.h>
+#include<glob.h>
+#include<fcntl.h>
+#include<unistd.h>
+
+#define LOG_TAG "[SaX3-Conf]"
+
+using namespace std;
+
+namespace Conf{
+
+	struct Token{
+		string_view text;
+		size_t begin,end;
+		bool quoted;
+	};
+
+	static bool is(string_view token,const char * keyword){
+		return token.size()==strlen(keyword) && !strncasecmp(token.data(),keyword,token.size());
+	}
+
+	//Split [b,e) into words and quoted strings, stopping at a comment
+	static void tokenize(const char * p,size_t b,size_t e,vector<Token> &tok){
+		tok.clear();
+		size_t i=b;
+		while(i<e){
+			while(i<e && (p[i]==' ' || p[i]=='\t' || p[i]=='\r'))
+				++i;
+			if(i>=e || p[i]=='#')
+				break;
+			Token t;
+			t.begin = i;
+			if(p[i]=='"'){
+				size_t close = i+1;
+				while(close<e && p[close]!='"')
+					++close;
+				t.text = string_view(p+i+1,close-i-1);
+				t.end = close<e ? close+1 : e;
+				t.quoted = true;
+			}else{
+				size_t end = i;
+				while(end<e && p[end]!=' ' && p[end]!='\t' && p[end]!='\r' && p[end]!='"' && p[end]!='#')
+					++end;
+				t.text = string_view(p+i,end-i);
+				t.end = end;
+				t.quoted = false;
+			}
+			i = t.end;
+			tok.push_back(t);
+		}
+	}
+
+	static string format(const string &key,const string &value){
+		return quotedKeyword(key) ? "\""+value+"\"" : value;
+	}
+
+	NativeBackend::NativeBackend(const char * r) : Backend(r){
+	}
+
+	const char * NativeBackend::name(){
+		return "native";
+	}
+
+	void NativeBackend::parse(NativeFile * f){
+		f->sections.clear();
+		if(!f->map.open(root+f->path))
+			return;
+		const char * p = f->map.data();
+		size_t size = f->map.size();
+		vector<Token> tok;
+		NativeSection * cur = NULL;
+		bool inSub=false,inDisplay=false;
+		size_t b=0;
+		while(b<size){
+			const char * nl = (const char*)memchr(p+b,'\n',size-b);
+			size_t e = nl ? nl-p : size;
+			size_t next = nl ? e+1 : size;
+			tokenize(p,b,e,tok);
+			if(tok.empty()){
+				b = next;
+				continue;
+			}
+			string_view kw = tok[0].text;
+			if(is(kw,"Section") && tok.size()>=2){
+				NativeSection s;
+				s.type = tok[1].text;
+				s.begin = b;
+				s.end = s.displayEnd = string_view::npos;
+				f->sections.push_back(s);
+				cur = &f->sections.back();
+				inSub = inDisplay = false;
+			}else if(cur==NULL){
+				//stray line outside of any section
+			}else if(is(kw,"EndSection")){
+				cur->end = b;
+				cur = NULL;
+			}else if(is(kw,"SubSection")){
+				inSub = true;
+				inDisplay = tok.size()>=2 && is(tok[1].text,"Display");
+			}else if(is(kw,"EndSubSection")){
+				if(inDisplay && cur->displayEnd==string_view::npos)
+					cur->displayEnd = b;
+				inSub = inDisplay = false;
+			}else if(!inSub || inDisplay){
+				NativeEntry en;
+				en.lineBegin = b;
+				en.lineEnd = next;
+				if(inDisplay){
+					en.kind = Entry::DISPLAY;
+				}else if(is(kw,"Option")){
+					en.kind = Entry::OPTION;
+				}else{
+					en.kind = Entry::PLAIN;
+				}
+				if(en.kind==Entry::OPTION){
+					if(tok.size()<2){
+						b = next;
+						continue;
+					}
+					en.key = tok[1].text;
+					if(tok.size()>=3){
+						en.value = tok[2].text;
+						en.valueBegin = tok[2].begin;
+						en.valueEnd = tok[2].end;
+					}else{
+						en.valueBegin = en.valueEnd = tok[1].end;
+					}
+				}else{
+					en.key = kw;
+					if(tok.size()==2 && tok[1].quoted){
+						en.value = tok[1].text;
+						en.valueBegin = tok[1].begin;
+						en.valueEnd = tok[1].end;
+					}else if(tok.size()>=2){
+						en.valueBegin = tok[1].begin;
+						en.valueEnd = tok.back().end;
+						en.value = string_view(p+en.valueBegin,en.valueEnd-en.valueBegin);
+					}else{
+						en.valueBegin = en.valueEnd = tok[0].end;
+					}
+				}
+				cur->entries.push_back(en);
+			}
+			b = next;
+		}
+	}
+
+	void NativeBackend::addFile(const string &path){
+		NativeFile * f = new NativeFile();
+		f->path = path;
+		parse(f);
+		if(!f->map.isOpen()){
+			delete f;
+			return;
+		}
+		vector<NativeFile*>::iterator it = files.begin();
+		while(it!=files.end() && (*it)->path<path)
+			++it;
+		files.insert(it,f);
+	}
+
+	bool NativeBackend::load(){
+		clear();
+		addFile("/etc/X11/xorg.conf");
+		glob_t g;
+		string pattern = root+"/etc/X11/xorg.conf.d/*.conf";
+		if(glob(pattern.c_str(),0,NULL,&g)==0){
+			for(size_t i=0;i<g.gl_pathc;i++)
+				addFile(string(g.gl_pathv[i]).substr(root.size()));
+			globfree(&g);
+		}
+		return true;
+	}
+
+	int NativeBackend::fileCount(){
+		return files.size();
+	}
+
+	NativeFile * NativeBackend::findFile(const string &path){
+		for(unsigned i=0;i<files.size();i++)
+			if(files[i]->path==path)
+				return files[i];
+		return NULL;
+	}
+
+	string NativeFile::nodePath(const string &type,int n) const{
+		char idx[16];
+		sprintf(idx,"[%d]",n);
+		return "/files"+path+"/"+type+idx;
+	}
+
+	NativeSection * NativeBackend::findSection(NativeFile * f,const string &path){
+		if(f==NULL)
+			return NULL;
+		map<string_view,int> seen;
+		for(unsigned j=0;j<f->sections.size();j++){
+			string_view type = f->sections[j].type;
+			int n = ++seen[type];
+			if(f->nodePath(string(type),n)==path)
+				return &f->sections[j];
+		}
+		return NULL;
+	}
+
+	void NativeBackend::sections(vector<Section> &list){
+		for(unsigned i=0;i<files.size();i++){
+			NativeFile * f = files[i];
+			map<string_view,int> seen;
+			for(unsigned j=0;j<f->sections.size();j++){
+				NativeSection &ns = f->sections[j];
+				Section s;
+				s.file = f->path;
+				s.type = string(ns.type);
+				int n = ++seen[ns.type];
+				s.path = f->nodePath(s.type,n);
+				for(unsigned k=0;k<ns.entries.size();k++)
+					s.entries.push_back(Entry(ns.entries[k].kind,string(ns.entries[k].key),string(ns.entries[k].value)));
+				list.push_back(s);
+			}
+		}
+	}
+
+	string NativeBackend::render(const SectionEdit &edit,int &touched){
+		string text = "Section \""+edit.type+"\"\n",display;
+		++touched;
+		for(unsigned i=0;i<edit.entries.size();i++){
+			const Entry &e = edit.entries[i];
+			//nothing to remove from a section that is only being created
+			if(e.remove)
+				continue;
+			switch(e.kind){
+			case Entry::OPTION:
+				text += "\tOption \""+e.key+"\" \""+e.value+"\"\n";
+				touched+=2;
+				break;
+			case Entry::DISPLAY:
+				if(display.empty())
+					++touched;
+				display += "\t\t"+e.key+" "+format(e.key,e.value)+"\n";
+				++touched;
+				break;
+			default:
+				text += "\t"+e.key+" "+format(e.key,e.value)+"\n";
+				++touched;
+			}
+		}
+		if(!display.empty())
+			text += "\tSubSection \"Display\"\n"+display+"\tEndSubSection\n";
+		text += "EndSection\n";
+		return text;
+	}
+
+	/* Splice the changed entries of an existing section into its text: values
+	 * are replaced where they stand, new lines go right before EndSection (or
+	 * EndSubSection for Display entries) and removed lines are cut out. */
+	void NativeBackend::update(NativeSection * s,const SectionEdit &edit,vector<Splice> &list,int &touched){
+		string display;
+		for(unsigned i=0;i<edit.entries.size();i++){
+			const Entry &e = edit.entries[i];
+			const NativeEntry * current = NULL;
+			Splice sp;
+			if(e.multi && e.remove){
+				for(unsigned j=0;j<s->entries.size();j++){
+					if(s->entries[j].kind!=e.kind || s->entries[j].key!=e.key)
+						continue;
+					sp.offset = s->entries[j].lineBegin;
+					sp.length = s->entries[j].lineEnd-s->entries[j].lineBegin;
+					list.push_back(sp);
+					++touched;
+				}
+				continue;
+			}
+			for(unsigned j=0;j<s->entries.size() && current==NULL && !e.multi;j++)
+				if(s->entries[j].kind==e.kind && s->entries[j].key==e.key)
+					current = &s->entries[j];
+			if(e.remove){
+				if(current==NULL)
+					continue;
+				sp.offset = current->lineBegin;
+				sp.length = current->lineEnd-current->lineBegin;
+				list.push_back(sp);
+				++touched;
+				continue;
+			}
+			string value = e.kind==Entry::OPTION ? "\""+e.value+"\"" : format(e.key,e.value);
+			if(current!=NULL){
+				sp.offset = current->valueBegin;
+				sp.length = current->valueEnd-current->valueBegin;
+				sp.text = sp.length ? value : " "+value;
+				list.push_back(sp);
+				++touched;
+				continue;
+			}
+			sp.length = 0;
+			if(e.kind==Entry::OPTION){
+				sp.offset = s->end;
+				sp.text = "\tOption \""+e.key+"\" "+value+"\n";
+				touched+=2;
+			}else if(e.kind==Entry::DISPLAY){
+				if(s->displayEnd==string_view::npos){
+					display += "\t\t"+e.key+" "+value+"\n";
+					++touched;
+					continue;
+				}
+				sp.offset = s->displayEnd;
+				sp.text = "\t\t"+e.key+" "+value+"\n";
+				++touched;
+			}else{
+				sp.offset = s->end;
+				sp.text = "\t"+e.key+" "+value+"\n";
+				++touched;
+			}
+			list.push_back(sp);
+		}
+		if(!display.empty()){
+			Splice sp;
+			sp.offset = s->end;
+			sp.length = 0;
+			sp.text = "\tSubSection \"Display\"\n"+display+"\tEndSubSection\n";
+			list.push_back(sp);
+			++touched;
+		}
+	}
+
+	bool NativeBackend::writeFile(const string &path,const string &content){
+		int fd = open(path.c_str(),O_WRONLY|O_CREAT|O_TRUNC|O_CLOEXEC,0644);
+		if(fd==-1)
+			return false;
+		size_t done=0;
+		while(done<content.size()){
+			ssize_t n = write(fd,content.data()+done,content.size()-done);
+			if(n<=0){
+				close(fd);
+				return false;
+			}
+			done+=n;
+		}
+		return close(fd)==0;
+	}
+
+	bool NativeBackend::commit(vector<SectionEdit> &edits,int &touched){
+		map< string,vector<Splice> > splices;
+		for(unsigned i=0;i<edits.size();i++){
+			NativeFile * f = findFile(edits[i].file);
+			if(!edits[i].path.empty()){
+				NativeSection * s = findSection(f,edits[i].path);
+				if(s==NULL || s->end==string_view::npos){
+					cout<<LOG_TAG<<" Section "<<edits[i].path<<" is gone"<<endl;
+					return false;
+				}
+				update(s,edits[i],splices[edits[i].file],touched);
+				continue;
+			}
+			Splice s;
+			s.offset = f ? f->map.size() : 0;
+			s.length = 0;
+			s.text = render(edits[i],touched);
+			splices[edits[i].file].push_back(s);
+		}
+
+		vector<string> targets;
+		bool ok = true;
+		map< string,vector<Splice> >::iterator it;
+		for(it=splices.begin();it!=splices.end() && ok;it++){
+			NativeFile * f = findFile(it->first);
+			const char * p = (f && f->map.data()) ? f->map.data() : "";
+			size_t size = f ? f->map.size() : 0,pos=0;
+			bool terminated = size==0 || p[size-1]=='\n';
+			vector<Splice> &list = it->second;
+			stable_sort(list.begin(),list.end());
+			string content;
+			content.reserve(size+1024);
+			for(unsigned i=0;i<list.size();i++){
+				content.append(p+pos,list[i].offset-pos);
+				if(list[i].offset==size && !terminated){
+					content.push_back('\n');
+					terminated = true;
+				}
+				content.append(list[i].text);
+				pos = list[i].offset+list[i].length;
+			}
+			content.append(p+pos,size-pos);
+			targets.push_back(root+it->first);
+			ok = writeFile(targets.back()+".augnew",content);
+		}
+		if(!ok){
+			for(unsigned i=0;i<targets.size();i++)
+				unlink((targets[i]+".augnew").c_str());
+			return false;
+		}
+		if(!install(targets))
+			return false;
+		for(it=splices.begin();it!=splices.end();it++){
+			NativeFile * f = findFile(it->first);
+			if(f)
+				parse(f);
+			else
+				addFile(it->first);
+		}
+		return true;
+	}
+
+	void NativeBackend::clear(){
+		for(unsigned i=0;i<files.size();i++)
+			delete files[i];
+		files.clear();
+	}
+
+	NativeBackend::~NativeBackend(){
+		clear();
+	}
+}
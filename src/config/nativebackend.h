@@ -0,0 +1,83 @@
+#ifndef NATIVEBACKEND_H_
+#define NATIVEBACKEND_H_
+
+#include "backend.h"
+#include "../util/mappedfile.h"
+
+#include<string>
+#include<string_view>
+#include<vector>
+
+namespace Conf{
+
+/*! \struct NativeEntry
+    \brief An entry as found in the mapped buffer
+
+    value points into the mapping without quotes, [valueBegin,valueEnd) is the
+    byte range of the value as written, quotes included, and
+    [lineBegin,lineEnd) the whole line with its newline.
+    */
+	struct NativeEntry{
+		Entry::Kind kind;
+		std::string_view key;
+		std::string_view value;
+		size_t valueBegin,valueEnd;
+		size_t lineBegin,lineEnd;
+	};
+
+/*! \struct NativeSection
+    \brief Offsets of a section inside its file
+
+    begin is the offset of the Section line, end the offset of the EndSection
+    line and displayEnd the offset of the first EndSubSection of a Display
+    subsection (std::string_view::npos if there is none).
+    */
+	struct NativeSection{
+		std::string_view type;
+		size_t begin,end,displayEnd;
+		std::vector<NativeEntry> entries;
+	};
+
+	struct NativeFile{
+		std::string path;
+		std::string nodePath(const std::string &type,int n) const;
+		Util::MappedFile map;
+		std::vector<NativeSection> sections;
+	};
+
+/*! \class NativeBackend
+    \brief Zero-copy xorg.conf reader and writer
+
+    Handles the subset of the grammar described by lens/xorg.aug: sections,
+    plain entries, Options and the Display subsection. Files are mapped and
+    tokenized in place, the tree only holds string views into the mappings.
+    Edits are spliced into the original text, so comments and formatting of
+    everything that is not touched survive a save byte for byte.
+    */
+	class NativeBackend : public Backend{
+		struct Splice{
+			size_t offset,length;
+			std::string text;
+			bool operator<(const Splice &o) const{ return offset<o.offset; }
+		};
+		std::vector<NativeFile*> files;
+		void parse(NativeFile * f);
+		NativeFile * findFile(const std::string &path);
+		NativeSection * findSection(NativeFile * f,const std::string &path);
+		void update(NativeSection * s,const SectionEdit &edit,std::vector<Splice> &list,int &touched);
+		void addFile(const std::string &path);
+		std::string render(const SectionEdit &edit,int &touched);
+		bool writeFile(const std::string &path,const std::string &content);
+		void clear();
+		public:
+		NativeBackend(const char * root);
+		const char * name();
+		bool load();
+		int fileCount();
+		void sections(std::vector<Section> &list);
+		bool commit(std::vector<SectionEdit> &edits,int &touched);
+		~NativeBackend();
+	};
+}
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef SECTION_H_
+#define SECTION_H_
+
+#include<string>
+#include<vector>
+
+namespace Conf{
+
+/*! \struct Entry
+    \brief One line of a section: a plain keyword, an Option or a Display subsection entry
+
+    Quoted arguments are stored without their quotes, for an Option the key is
+    the option name and the value its first argument. In an edit, remove asks
+    for the entry to be dropped from the section. A multi edit works on a
+    keyword that may repeat, such as Inactive: removing drops every entry
+    with the key, anything else appends one more line.
+    */
+	struct Entry{
+		enum Kind{PLAIN,OPTION,DISPLAY};
+		Kind kind;
+		std::string key;
+		std::string value;
+		bool remove,multi;
+		Entry(Kind k,const std::string &n,const std::string &v,bool r=false,bool m=false) : kind(k),key(n),value(v),remove(r),multi(m){}
+	};
+
+/*! \struct Section
+    \brief A section as read back from the backend
+
+    path is the Augeas style node path, e.g.
+    /files/etc/X11/xorg.conf.d/10-evdev.conf/InputClass[2], for both backends.
+    */
+	struct Section{
+		std::string file;
+		std::string path;
+		std::string type;
+		std::vector<Entry> entries;
+		const Entry * find(Entry::Kind kind,const std::string &key) const{
+			for(unsigned i=0;i<entries.size();i++)
+				if(entries[i].kind==kind && entries[i].key==key)
+					return &entries[i];
+			return NULL;
+		}
+	};
+
+/*! \struct SectionEdit
+    \brief A section queued by a Transaction, written to file on commit
+
+    When path is set the edit updates that existing section in place,
+    otherwise a new section is appended to file.
+    */
+	struct SectionEdit{
+		std::string file;
+		std::string type;
+		std::string identifier;
+		std::string path;
+		std::vector<Entry> entries;
+	};
+}
+
+#endif
@@ -0,0 +1,139 @@
+#include "sectionindex.h"
+
+#include<stdio.h>
+
+using namespace std;
+
+namespace Conf{
+
+	static const vector<int> noSections;
+	static const vector<OptionRef> noOptions;
+
+	SectionIndex::SectionIndex(){
+		tree = NULL;
+	}
+
+	void SectionIndex::build(const vector<Section> &sections){
+		tree = &sections;
+		types.clear();
+		identifiers.clear();
+		matches.clear();
+		options.clear();
+		lastFiles.clear();
+		for(unsigned i=0;i<sections.size();i++)
+			add(i);
+	}
+
+	void SectionIndex::add(int id){
+		const Section &s = (*tree)[id];
+		types[s.type].push_back(id);
+		bool dropIn = !s.file.compare(0,21,"/etc/X11/xorg.conf.d/");
+		if(dropIn && !s.entries.empty()){
+			string &last = lastFiles[Key(s.type,"*")];
+			if(last<s.file)
+				last = s.file;
+		}
+		int n=0;
+		for(unsigned i=0;i<s.entries.size();i++){
+			const Entry &e = s.entries[i];
+			if(e.kind==Entry::OPTION){
+				char idx[32];
+				snprintf(idx,sizeof(idx),"/Option[%d]",++n);
+				OptionRef ref;
+				ref.section = id;
+				ref.path = s.path+idx;
+				ref.value = e.value;
+				options[e.key].push_back(ref);
+				continue;
+			}
+			if(e.kind!=Entry::PLAIN)
+				continue;
+			if(e.key=="Identifier")
+				identifiers[Key(s.type,e.value)] = id;
+			if(!e.key.compare(0,5,"Match"))
+				matches.insert(make_pair(Key(e.key,e.value),id));
+			if(dropIn){
+				string &last = lastFiles[Key(s.type,e.key)];
+				if(last<s.file)
+					last = s.file;
+			}
+		}
+	}
+
+	/* Forget everything a section contributed except its type and the
+	 * last-file table, neither of which can change through an update. */
+	void SectionIndex::drop(int id){
+		map<Key,int>::iterator i = identifiers.begin();
+		while(i!=identifiers.end()){
+			if(i->second==id)
+				identifiers.erase(i++);
+			else
+				++i;
+		}
+		multimap<Key,int>::iterator m = matches.begin();
+		while(m!=matches.end()){
+			if(m->second==id)
+				matches.erase(m++);
+			else
+				++m;
+		}
+		map< string,vector<OptionRef> >::iterator o;
+		for(o=options.begin();o!=options.end();o++){
+			vector<OptionRef> &refs = o->second;
+			for(unsigned k=0;k<refs.size();){
+				if(refs[k].section==id)
+					refs.erase(refs.begin()+k);
+				else
+					++k;
+			}
+		}
+	}
+
+	void SectionIndex::update(int id){
+		drop(id);
+		vector<int> &list = types[(*tree)[id].type];
+		for(unsigned i=0;i<list.size();i++){
+			if(list[i]==id){
+				list.erase(list.begin()+i);
+				break;
+			}
+		}
+		add(id);
+	}
+
+	const vector<int> & SectionIndex::byType(const string &type) const{
+		map< string,vector<int> >::const_iterator it = types.find(type);
+		return it==types.end() ? noSections : it->second;
+	}
+
+	int SectionIndex::byIdentifier(const string &type,const string &identifier) const{
+		map<Key,int>::const_iterator it = identifiers.find(Key(type,identifier));
+		return it==identifiers.end() ? -1 : it->second;
+	}
+
+	vector<int> SectionIndex::matching(const string &key,const string &value) const{
+		vector<int> ids;
+		pair<multimap<Key,int>::const_iterator,multimap<Key,int>::const_iterator> r = matches.equal_range(Key(key,value));
+		for(;r.first!=r.second;r.first++)
+			ids.push_back(r.first->second);
+		return ids;
+	}
+
+	const vector<OptionRef> & SectionIndex::option(const string &name) const{
+		map< string,vector<OptionRef> >::const_iterator it = options.find(name);
+		return it==options.end() ? noOptions : it->second;
+	}
+
+	const OptionRef * SectionIndex::option(const string &name,int section) const{
+		const vector<OptionRef> &refs = option(name);
+		for(unsigned i=0;i<refs.size();i++)
+			if(refs[i].section==section)
+				return &refs[i];
+		return NULL;
+	}
+
+	string SectionIndex::lastFile(const string &type,const string &entry) const{
+		map<Key,string>::const_iterator it = lastFiles.find(Key(type,entry));
+		return it==lastFiles.end() ? "" : it->second;
+	}
+}
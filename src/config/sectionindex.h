@@ -0,0 +1,52 @@
+#ifndef SECTIONINDEX_H_
+#define SECTIONINDEX_H_
+
+#include "section.h"
+
+#include<map>
+#include<string>
+#include<utility>
+#include<vector>
+
+namespace Conf{
+
+/*! \struct OptionRef
+    \brief Where an Option lives: the section it belongs to, its node path and value
+    */
+	struct OptionRef{
+		int section;
+		std::string path;
+		std::string value;
+	};
+
+/*! \class SectionIndex
+    \brief Lookup tables over the sections held by ConfigStore
+
+    Built once after loading and kept current section by section as commits
+    go through, so no load or save path has to scan the tree. Section ids are
+    positions in the ConfigStore snapshot, options are listed in file order.
+    */
+	class SectionIndex{
+		typedef std::pair<std::string,std::string> Key;
+		const std::vector<Section> * tree;
+		std::map< std::string,std::vector<int> > types;
+		std::map<Key,int> identifiers;
+		std::multimap<Key,int> matches;
+		std::map< std::string,std::vector<OptionRef> > options;
+		std::map<Key,std::string> lastFiles;
+		void drop(int id);
+		public:
+		SectionIndex();
+		void build(const std::vector<Section> &sections);
+		void add(int id);
+		void update(int id);
+		const std::vector<int> & byType(const std::string &type) const;
+		int byIdentifier(const std::string &type,const std::string &identifier) const;
+		std::vector<int> matching(const std::string &key,const std::string &value) const;
+		const std::vector<OptionRef> & option(const std::string &name) const;
+		const OptionRef * option(const std::string &name,int section) const;
+		std::string lastFile(const std::string &type,const std::string &entry) const;
+	};
+}
+
+#endif
@@ -0,0 +1,85 @@
+#include "transaction.h"
+
+#include<iostream>
+#include<time.h>
+
+#define LOG_TAG "[SaX3-Conf]"
+
+using namespace std;
+
+namespace Conf{
+
+	static double now(){
+		struct timespec ts;
+		clock_gettime(CLOCK_MONOTONIC,&ts);
+		return ts.tv_sec*1000.0 + ts.tv_nsec/1000000.0;
+	}
+
+	Transaction::Transaction(ConfigStore * s){
+		store = s;
+		touched=0;commitTime=0;
+	}
+
+	void Transaction::beginSection(const string &file,const string &type,const string &identifier){
+		SectionEdit e;
+		e.file = file;
+		e.type = type;
+		e.identifier = identifier;
+		edits.push_back(e);
+	}
+
+	void Transaction::set(const string &key,const string &value){
+		edits.back().entries.push_back(Entry(Entry::PLAIN,key,value));
+	}
+
+	void Transaction::option(const string &name,const string &value){
+		edits.back().entries.push_back(Entry(Entry::OPTION,name,value));
+	}
+
+	void Transaction::unsetOption(const string &name){
+		edits.back().entries.push_back(Entry(Entry::OPTION,name,"",true));
+	}
+
+	void Transaction::unset(const string &key){
+		edits.back().entries.push_back(Entry(Entry::PLAIN,key,"",true));
+	}
+
+	void Transaction::setAll(const string &key,const vector<string> &values){
+		edits.back().entries.push_back(Entry(Entry::PLAIN,key,"",true,true));
+		for(unsigned i=0;i<values.size();i++)
+			edits.back().entries.push_back(Entry(Entry::PLAIN,key,values[i],false,true));
+	}
+
+	void Transaction::display(const string &key,const string &value){
+		edits.back().entries.push_back(Entry(Entry::DISPLAY,key,value));
+	}
+
+	void Transaction::unsetDisplay(const string &key){
+		edits.back().entries.push_back(Entry(Entry::DISPLAY,key,"",true));
+	}
+
+	bool Transaction::commit(){
+		double start = now();
+		touched=0;
+		bool ok = store->commit(edits,touched);
+		commitTime = now()-start;
+		if(ok)
+			cout<<LOG_TAG<<" Committed "<<touched<<" node(s) in "<<commitTime<<" ms"<<endl;
+		else
+			cout<<LOG_TAG<<" Commit failed after "<<commitTime<<" ms, changes rolled back"<<endl;
+		edits.clear();
+		return ok;
+	}
+
+	void Transaction::discard(){
+		edits.clear();
+	}
+
+	int Transaction::nodesTouched(){
+		return touched;
+	}
+
+	double Transaction::commitMillis(){
+		return commitTime;
+	}
+}
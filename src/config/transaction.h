@@ -0,0 +1,45 @@
+#ifndef TRANSACTION_H_
+#define TRANSACTION_H_
+
+#include "configstore.h"
+#include "section.h"
+
+#include<string>
+#include<vector>
+
+namespace Conf{
+
+/*! \class Transaction
+    \brief Collects section and option edits in memory and commits them in one pass
+
+    Nothing touches the tree until commit(). A section opened with an
+    Identifier is looked up first and updated in place, only the entries whose
+    value differs from the file are written. The commit writes every affected
+    file to a temporary file, fsyncs it and renames it over the original; on any
+    error the tree is reloaded and no file is left half written.
+    setAll() replaces every line of a repeatable keyword with one line per
+    value, or drops them all for an empty list.
+    */
+	class Transaction{
+		ConfigStore * store;
+		std::vector<SectionEdit> edits;
+		int touched;
+		double commitTime;
+		public:
+		Transaction(ConfigStore *);
+		void beginSection(const std::string &file,const std::string &type,const std::string &identifier="");
+		void set(const std::string &key,const std::string &value);
+		void option(const std::string &name,const std::string &value);
+		void unsetOption(const std::string &name);
+		void unset(const std::string &key);
+		void setAll(const std::string &key,const std::vector<std::string> &values);
+		void display(const std::string &key,const std::string &value);
+		void unsetDisplay(const std::string &key);
+		bool commit();
+		void discard();
+		int nodesTouched();
+		double commitMillis();
+	};
+}
+
+#endif
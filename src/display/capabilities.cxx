@@ -0,0 +1,81 @@
+#include "capabilities.h"
+
+#include<iostream>
+#include<algorithm>
+
+#define LOG_TAG "[SaX3-Display]"
+
+using namespace std;
+
+namespace Display{
+
+	/* Kernel drivers that drive the VRR connector properties */
+	static const char * vrrKernels[] = {"amdgpu","i915","xe",NULL};
+
+	/* Options per Xorg driver, those needing variable refresh marked */
+	static const struct{
+		const char * driver,* option;
+		bool needsVrr;
+	} driverOptions[] = {
+		{"amdgpu","VariableRefresh",true},
+		{"amdgpu","TearFree",false},
+		{"amdgpu","AsyncFlipSecondaries",false},
+		{"modesetting","VariableRefresh",true},
+		{"modesetting","TearFree",false},
+		{"modesetting","AsyncFlipSecondaries",false},
+		{"intel","TearFree",false},
+		{"intel","TripleBuffer",false},
+		{"radeon","TearFree",false}
+	};
+
+	Capabilities::Capabilities(){
+		vrr = false;
+		vrrLow = vrrHigh = 0;
+	}
+
+	void Capabilities::probe(const Card &card,const Connector &connector,const Edid &edid){
+		kernelDriver = card.driver;
+		vrrLow = edid.vrrMin();
+		vrrHigh = edid.vrrMax();
+		bool kernel = false;
+		for(int i=0;vrrKernels[i]!=NULL;i++){
+			if(kernelDriver==vrrKernels[i])
+				kernel = true;
+		}
+		vrr = kernel && (connector.vrrCapable==1 || (connector.vrrCapable==-1 && vrrHigh>0));
+		cout<<LOG_TAG<<' '<<connector.name<<" on "<<kernelDriver<<": VRR "<<(vrr ? "yes" : "no");
+		if(vrrHigh>0)
+			cout<<" ("<<vrrLow<<"-"<<vrrHigh<<" Hz)";
+		cout<<endl;
+	}
+
+	bool Capabilities::variableRefresh() const{
+		return vrr;
+	}
+
+	unsigned Capabilities::vrrMin() const{
+		return vrrLow;
+	}
+
+	unsigned Capabilities::vrrMax() const{
+		return vrrHigh;
+	}
+
+	vector<string> Capabilities::options(const string &xorgDriver) const{
+		vector<string> list;
+		for(unsigned i=0;i<sizeof(driverOptions)/sizeof(driverOptions[0]);i++){
+			if(xorgDriver==driverOptions[i].driver && (vrr || !driverOptions[i].needsVrr))
+				list.push_back(driverOptions[i].option);
+		}
+		return list;
+	}
+
+	vector<string> Capabilities::knownOptions(){
+		vector<string> list;
+		for(unsigned i=0;i<sizeof(driverOptions)/sizeof(driverOptions[0]);i++){
+			if(find(list.begin(),list.end(),driverOptions[i].option)==list.end())
+				list.push_back(driverOptions[i].option);
+		}
+		return list;
+	}
+}
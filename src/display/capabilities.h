@@ -0,0 +1,38 @@
+#ifndef CAPABILITIES_H_
+#define CAPABILITIES_H_
+
+#include "detector.h"
+#include "edid.h"
+
+#include<string>
+#include<vector>
+
+namespace Display{
+
+/*! \class Capabilities
+    \brief Xorg driver options a card, connector and monitor can make use of
+
+    probe() takes the kernel driver of the card, the connector's vrr_capable
+    attribute and the monitor's EDID. Variable refresh needs a kernel driver
+    with VRR support and a connector that reports it, or, where the kernel
+    does not export vrr_capable, an EDID with a VRR range. options() lists
+    the driver options that make sense for one Xorg driver on that
+    combination, knownOptions() every option any driver is offered, so
+    stale ones can be removed from a configuration.
+    */
+	class Capabilities{
+		std::string kernelDriver;
+		bool vrr;
+		unsigned vrrLow,vrrHigh;
+		public:
+		Capabilities();
+		void probe(const Card &card,const Connector &connector,const Edid &edid);
+		bool variableRefresh() const;
+		unsigned vrrMin() const;
+		unsigned vrrMax() const;
+		std::vector<std::string> options(const std::string &xorgDriver) const;
+		static std::vector<std::string> knownOptions();
+	};
+}
+
+#endif
@@ -0,0 +1,204 @@
+#include "cvt.h"
+
+#include<stdio.h>
+#include<math.h>
+
+/* CVT constants, named as in the VESA text */
+#define CVT_MARGIN_PERCENTAGE 1.8
+#define CVT_H_GRANULARITY 8
+#define CVT_MIN_V_PORCH 3
+#define CVT_MIN_V_BPORCH 6
+#define CVT_CLOCK_STEP 250
+#define CVT_MIN_VSYNC_BP 550.0
+#define CVT_HSYNC_PERCENTAGE 8
+#define CVT_C_PRIME 30
+#define CVT_M_PRIME 300
+#define CVT_RB_MIN_VBLANK 460.0
+#define CVT_RB_H_SYNC 32.0
+#define CVT_RB_H_BLANK 160.0
+#define CVT_RB_VFPORCH 3
+#define CVT_RB2_H_BLANK 80
+#define CVT_RB2_H_FPORCH 8
+#define CVT_RB2_V_SYNC 8
+#define CVT_RB2_MIN_VFPORCH 1
+
+/* GTF constants */
+#define GTF_CELL_GRAN 8.0
+#define GTF_MIN_PORCH 1
+#define GTF_V_SYNC_RQD 3
+#define GTF_H_SYNC_PERCENT 8.0
+#define GTF_MIN_VSYNC_PLUS_BP 550.0
+#define GTF_C_PRIME 30.0
+#define GTF_M_PRIME 300.0
+
+using namespace std;
+
+namespace Display{
+
+	/* Reduced blanking v2, every step done in double with the 1 kHz clock
+	 * granularity of CVT 1.2. */
+	static Timing reducedV2(unsigned width,unsigned height,double refresh,bool interlaced){
+		Timing t;
+		double fieldRate = interlaced ? refresh*2 : refresh;
+		unsigned lines = interlaced ? height/2 : height;
+		double period = (1000000.0/fieldRate - CVT_RB_MIN_VBLANK)/lines;
+		unsigned vbi = (unsigned)floor(CVT_RB_MIN_VBLANK/period)+1;
+		if(vbi<CVT_RB2_MIN_VFPORCH+CVT_RB2_V_SYNC+CVT_MIN_V_BPORCH)
+			vbi = CVT_RB2_MIN_VFPORCH+CVT_RB2_V_SYNC+CVT_MIN_V_BPORCH;
+		double totalLines = lines+vbi+(interlaced ? 0.5 : 0.0);
+		t.hActive = width;
+		t.hTotal = width+CVT_RB2_H_BLANK;
+		t.hSyncStart = width+CVT_RB2_H_FPORCH;
+		t.hSyncEnd = t.hSyncStart+CVT_RB_H_SYNC;
+		t.clock = (unsigned)floor(fieldRate*totalLines*t.hTotal/1000.0);
+		t.vActive = height;
+		t.vSyncStart = height+(vbi-CVT_RB2_V_SYNC-CVT_MIN_V_BPORCH);
+		t.vSyncEnd = t.vSyncStart+CVT_RB2_V_SYNC;
+		t.vTotal = (unsigned)totalLines;
+		if(interlaced)
+			t.vTotal *= 2;
+		t.hSyncPositive = true;
+		t.vSyncPositive = false;
+		char name[48];
+		snprintf(name,sizeof(name),"%ux%uR2_%.2f",width,height,refresh);
+		t.name = name;
+		return t;
+	}
+
+	/* Mirrors xf86CVTMode including its float/int mix, which is what makes
+	 * the result match cvt to the last digit. */
+	Timing cvt(unsigned width,unsigned height,double refresh,Blanking blanking,bool interlaced){
+		if(refresh<=0)
+			refresh = 60;
+		if(blanking==REDUCED_V2){
+			Timing t = reducedV2(width,height,refresh,interlaced);
+			t.interlaced = interlaced;
+			t.preferred = false;
+			return t;
+		}
+		bool reduced = blanking==REDUCED;
+		int HDisplay = width,VDisplay = height;
+		if(HDisplay & 0x07){
+			HDisplay &= ~0x07;
+			HDisplay += 8;
+		}
+		float VRefresh = refresh;
+		float VFieldRate = interlaced ? VRefresh*2 : VRefresh;
+		float HPeriod;
+		int hDisplay = HDisplay-(HDisplay%CVT_H_GRANULARITY);
+		int VDisplayRnd = interlaced ? VDisplay/2 : VDisplay;
+		float Interlace = interlaced ? 0.5 : 0.0;
+		int VSync;
+		if(!(VDisplay%3) && ((VDisplay*4/3)==HDisplay))
+			VSync = 4;
+		else if(!(VDisplay%9) && ((VDisplay*16/9)==HDisplay))
+			VSync = 5;
+		else if(!(VDisplay%10) && ((VDisplay*16/10)==HDisplay))
+			VSync = 6;
+		else if(!(VDisplay%4) && ((VDisplay*5/4)==HDisplay))
+			VSync = 7;
+		else if(!(VDisplay%9) && ((VDisplay*15/9)==HDisplay))
+			VSync = 7;
+		else
+			VSync = 10;
+
+		int HTotal,HSyncStart,HSyncEnd,VTotal,VSyncStart,VSyncEnd;
+		if(!reduced){
+			HPeriod = ((float)(1000000.0/VFieldRate-CVT_MIN_VSYNC_BP))/(VDisplayRnd+CVT_MIN_V_PORCH+Interlace);
+			int VSyncAndBackPorch;
+			if(((int)(CVT_MIN_VSYNC_BP/HPeriod)+1)<(VSync+CVT_MIN_V_PORCH))
+				VSyncAndBackPorch = VSync+CVT_MIN_V_PORCH;
+			else
+				VSyncAndBackPorch = (int)(CVT_MIN_VSYNC_BP/HPeriod)+1;
+			VTotal = VDisplayRnd+VSyncAndBackPorch+Interlace+CVT_MIN_V_PORCH;
+			float HBlankPercentage = CVT_C_PRIME-CVT_M_PRIME*HPeriod/1000.0;
+			if(HBlankPercentage<20)
+				HBlankPercentage = 20;
+			int HBlank = hDisplay*HBlankPercentage/(100.0-HBlankPercentage);
+			HBlank -= HBlank%(2*CVT_H_GRANULARITY);
+			HTotal = hDisplay+HBlank;
+			HSyncEnd = hDisplay+HBlank/2;
+			HSyncStart = HSyncEnd-(HTotal*CVT_HSYNC_PERCENTAGE)/100;
+			HSyncStart += CVT_H_GRANULARITY-HSyncStart%CVT_H_GRANULARITY;
+			VSyncStart = VDisplay+CVT_MIN_V_PORCH;
+			VSyncEnd = VSyncStart+VSync;
+		}else{
+			HPeriod = ((float)(1000000.0/VFieldRate-CVT_RB_MIN_VBLANK))/VDisplayRnd;
+			int VBILines = ((float)CVT_RB_MIN_VBLANK)/HPeriod+1;
+			if(VBILines<(CVT_RB_VFPORCH+VSync+CVT_MIN_V_BPORCH))
+				VBILines = CVT_RB_VFPORCH+VSync+CVT_MIN_V_BPORCH;
+			VTotal = VDisplayRnd+Interlace+VBILines;
+			HTotal = hDisplay+CVT_RB_H_BLANK;
+			HSyncEnd = hDisplay+CVT_RB_H_BLANK/2;
+			HSyncStart = HSyncEnd-CVT_RB_H_SYNC;
+			VSyncStart = VDisplay+CVT_RB_VFPORCH;
+			VSyncEnd = VSyncStart+VSync;
+		}
+		int Clock = HTotal*1000.0/HPeriod;
+		Clock -= Clock%CVT_CLOCK_STEP;
+		if(interlaced)
+			VTotal *= 2;
+
+		Timing t;
+		t.clock = Clock;
+		t.hActive = hDisplay;
+		t.hSyncStart = HSyncStart;
+		t.hSyncEnd = HSyncEnd;
+		t.hTotal = HTotal;
+		t.vActive = VDisplay;
+		t.vSyncStart = VSyncStart;
+		t.vSyncEnd = VSyncEnd;
+		t.vTotal = VTotal;
+		t.interlaced = interlaced;
+		t.hSyncPositive = reduced;
+		t.vSyncPositive = !reduced;
+		t.preferred = false;
+		char name[48];
+		if(reduced)
+			snprintf(name,sizeof(name),"%dx%dR",HDisplay,VDisplay);
+		else
+			snprintf(name,sizeof(name),"%dx%d_%.2f",HDisplay,VDisplay,VRefresh);
+		t.name = name;
+		return t;
+	}
+
+	/* Same float arithmetic as the gtf tool */
+	Timing gtf(unsigned width,unsigned height,double refresh,bool interlaced){
+		float vrefresh = refresh<=0 ? 60 : refresh;
+		float h_pixels_rnd = rint((float)width/GTF_CELL_GRAN)*GTF_CELL_GRAN;
+		float v_lines_rnd = interlaced ? rint((float)height/2.0) : height;
+		float v_field_rate_rqd = interlaced ? vrefresh*2.0 : vrefresh;
+		float interlace = interlaced ? 0.5 : 0.0;
+		float h_period_est = (((1.0/v_field_rate_rqd)-(GTF_MIN_VSYNC_PLUS_BP/1000000.0))/(v_lines_rnd+GTF_MIN_PORCH+interlace)*1000000.0);
+		float vsync_plus_bp = rint(GTF_MIN_VSYNC_PLUS_BP/h_period_est);
+		float total_v_lines = v_lines_rnd+vsync_plus_bp+interlace+GTF_MIN_PORCH;
+		float v_field_rate_est = 1.0/h_period_est/total_v_lines*1000000.0;
+		float h_period = h_period_est/(v_field_rate_rqd/v_field_rate_est);
+		float ideal_duty_cycle = GTF_C_PRIME-(GTF_M_PRIME*h_period/1000.0);
+		float h_blank = rint(h_pixels_rnd*ideal_duty_cycle/(100.0-ideal_duty_cycle)/(2.0*GTF_CELL_GRAN))*(2.0*GTF_CELL_GRAN);
+		float total_pixels = h_pixels_rnd+h_blank;
+		float pixel_freq = total_pixels/h_period;
+		float h_sync = rint(GTF_H_SYNC_PERCENT/100.0*total_pixels/GTF_CELL_GRAN)*GTF_CELL_GRAN;
+		float h_front_porch = (h_blank/2.0)-h_sync;
+		float v_odd_front_porch_lines = GTF_MIN_PORCH+interlace;
+
+		Timing t;
+		t.clock = (unsigned)rint(pixel_freq*1000.0);
+		t.hActive = (int)h_pixels_rnd;
+		t.hSyncStart = (int)(h_pixels_rnd+h_front_porch);
+		t.hSyncEnd = (int)(h_pixels_rnd+h_front_porch+h_sync);
+		t.hTotal = (int)total_pixels;
+		t.vActive = (int)v_lines_rnd;
+		t.vSyncStart = (int)(v_lines_rnd+v_odd_front_porch_lines);
+		t.vSyncEnd = (int)(v_lines_rnd+v_odd_front_porch_lines+GTF_V_SYNC_RQD);
+		t.vTotal = (int)total_v_lines;
+		t.interlaced = interlaced;
+		t.hSyncPositive = false;
+		t.vSyncPositive = true;
+		t.preferred = false;
+		char name[48];
+		snprintf(name,sizeof(name),"%ux%u_%.2f",width,height,vrefresh);
+		t.name = name;
+		return t;
+	}
+}
@@ -0,0 +1,24 @@
+#ifndef CVT_H_
+#define CVT_H_
+
+#include "timing.h"
+
+namespace Display{
+
+	enum Blanking{STANDARD,REDUCED,REDUCED_V2};
+
+/*! \brief VESA CVT 1.2 timing for a resolution and refresh rate
+
+    STANDARD and REDUCED follow the X server's CVT code and give the same
+    numbers and name the cvt tool prints, including its rounding of the
+    width up to a multiple of 8. REDUCED_V2 is reduced blanking version 2
+    with its fixed 80 pixel blank and 1 kHz clock steps.
+    */
+	Timing cvt(unsigned width,unsigned height,double refresh=60,Blanking blanking=STANDARD,bool interlaced=false);
+
+/*! \brief VESA GTF timing, as the gtf tool computes it
+    */
+	Timing gtf(unsigned width,unsigned height,double refresh=60,bool interlaced=false);
+}
+
+#endif
@@ -0,0 +1,231 @@
+#include "detector.h"
+#include "sysfs.h"
+
+#include<iostream>
+#include<atomic>
+#include<thread>
+#include<algorithm>
+#include<stdlib.h>
+#include<string.h>
+#include<ctype.h>
+#include<time.h>
+#include<dirent.h>
+
+#define LOG_TAG "[SaX3-Display]"
+
+using namespace std;
+
+namespace Display{
+
+	static double now(){
+		struct timespec ts;
+		clock_gettime(CLOCK_MONOTONIC,&ts);
+		return ts.tv_sec*1000.0 + ts.tv_nsec/1000000.0;
+	}
+
+	static string ueventValue(const string &uevent,const char * key){
+		size_t keyLength = strlen(key);
+		size_t pos = 0;
+		while(pos<uevent.size()){
+			size_t end = uevent.find('\n',pos);
+			if(end==string::npos)
+				end = uevent.size();
+			if(end-pos>keyLength && uevent.compare(pos,keyLength,key)==0 && uevent[pos+keyLength]=='=')
+				return uevent.substr(pos+keyLength+1,end-pos-keyLength-1);
+			pos = end+1;
+		}
+		return "";
+	}
+
+	/* card number of a cardN or cardN-<connector> entry, -1 for anything
+	 * else such as renderD128 or version */
+	static int cardNumber(const char * name,const char ** rest){
+		if(strncmp(name,"card",4)!=0 || name[4]<'0' || name[4]>'9')
+			return -1;
+		char * end;
+		long n = strtol(name+4,&end,10);
+		if(*end!=0 && *end!='-')
+			return -1;
+		*rest = end;
+		return n;
+	}
+
+	/* strcmp with runs of digits compared by value, DP-2 before DP-10 */
+	static int naturalCompare(const char * a,const char * b){
+		while(*a && *b){
+			if(isdigit((unsigned char)*a) && isdigit((unsigned char)*b)){
+				char * ea,* eb;
+				unsigned long na = strtoul(a,&ea,10),nb = strtoul(b,&eb,10);
+				if(na!=nb)
+					return na<nb ? -1 : 1;
+				a = ea;
+				b = eb;
+				continue;
+			}
+			if(*a!=*b)
+				return (unsigned char)*a<(unsigned char)*b ? -1 : 1;
+			a++;
+			b++;
+		}
+		return *a ? 1 : *b ? -1 : 0;
+	}
+
+	static bool entryOrder(const string &a,const string &b){
+		const char * ra,* rb;
+		int na = cardNumber(a.c_str(),&ra),nb = cardNumber(b.c_str(),&rb);
+		if(na!=nb)
+			return na<nb;
+		return naturalCompare(ra,rb)<0;
+	}
+
+	Detector::Detector(const char * sysfsRoot,unsigned maxWorkers){
+		root = Display::sysfsRoot(sysfsRoot);
+		workers = maxWorkers>0 ? maxWorkers : 1;
+		scanTime = 0;
+	}
+
+	void Detector::setWorkers(unsigned maxWorkers){
+		workers = maxWorkers>0 ? maxWorkers : 1;
+	}
+
+	void Detector::probeCard(const string &name,Card &card) const{
+		string dir = root+"/class/drm/"+name+"/device";
+		string uevent;
+		readFile(dir+"/uevent",uevent);
+		card.name = name;
+		card.driver = linkName(dir+"/driver");
+		if(card.driver.empty())
+			card.driver = ueventValue(uevent,"DRIVER");
+		card.busId = ueventValue(uevent,"PCI_SLOT_NAME");
+		if(card.busId.empty())
+			card.busId = linkName(dir);
+		card.vendor = strtoul(readLine(dir+"/vendor").c_str(),NULL,16);
+		card.device = strtoul(readLine(dir+"/device").c_str(),NULL,16);
+		card.bootVga = readLine(dir+"/boot_vga")=="1";
+	}
+
+	void Detector::probeConnector(const string &entry,Connector &c,Edid &edid) const{
+		string dir = root+"/class/drm/"+entry;
+		string status = readLine(dir+"/status");
+		c.status = status=="connected" ? CONNECTED : status=="disconnected" ? DISCONNECTED : UNKNOWN;
+		c.enabled = readLine(dir+"/enabled")=="enabled";
+		string vrr = readLine(dir+"/vrr_capable");
+		c.vrrCapable = vrr.empty() ? -1 : vrr=="1";
+		string modes;
+		readFile(dir+"/modes",modes);
+		size_t pos = 0,end;
+		while((end = modes.find('\n',pos))!=string::npos){
+			if(end>pos)
+				c.modes.push_back(modes.substr(pos,end-pos));
+			pos = end+1;
+		}
+		if(pos<modes.size())
+			c.modes.push_back(modes.substr(pos));
+		readFile(dir+"/edid",c.edid);
+		edid.parse(c.edid);
+		dpLink(dir,c);
+	}
+
+	/* DisplayPort receiver capabilities from the start of the DPCD, read
+	 * through the connector's AUX character device: MAX_LINK_RATE in
+	 * 0.27 Gbit/s units and MAX_LANE_COUNT. Left at 0 for other connectors
+	 * and where the device cannot be read, which takes root. */
+	void Detector::dpLink(const string &dir,Connector &c) const{
+		c.linkRate = c.lanes = 0;
+		DIR * dp = opendir(dir.c_str());
+		if(dp==NULL)
+			return;
+		string aux;
+		struct dirent * ep;
+		while((ep = readdir(dp))!=NULL){
+			if(strncmp(ep->d_name,"drm_dp_aux",10)==0)
+				aux = ep->d_name;
+		}
+		closedir(dp);
+		uint8_t dpcd[3];
+		if(aux.empty() || !readBytes(devRoot(root)+"/"+aux,0,dpcd,sizeof(dpcd)))
+			return;
+		c.linkRate = dpcd[1]*270;
+		c.lanes = dpcd[2]&0x1f;
+	}
+
+	bool Detector::scan(){
+		double start = now();
+		cardList.clear();
+		connectorList.clear();
+		model.clear();
+		string drm = root+"/class/drm";
+		DIR * dp = opendir(drm.c_str());
+		if(dp==NULL){
+			cerr<<LOG_TAG<<" Cannot open "<<drm<<endl;
+			return false;
+		}
+		vector<string> entries;
+		struct dirent * ep;
+		const char * rest;
+		while((ep = readdir(dp))!=NULL){
+			if(cardNumber(ep->d_name,&rest)>=0)
+				entries.push_back(ep->d_name);
+		}
+		closedir(dp);
+		sort(entries.begin(),entries.end(),entryOrder);
+
+		/* Cards sort before their connectors, a connector whose card has
+		 * no entry of its own still gets one */
+		vector<string> cardNames,connectorEntries;
+		for(unsigned i=0;i<entries.size();i++){
+			cardNumber(entries[i].c_str(),&rest);
+			string card = entries[i].substr(0,rest-entries[i].c_str());
+			if(cardNames.empty() || cardNames.back()!=card)
+				cardNames.push_back(card);
+			if(*rest==0)
+				continue;
+			Connector c;
+			c.name = rest+1;
+			c.card = cardNames.size()-1;
+			connectorList.push_back(c);
+			connectorEntries.push_back(entries[i]);
+		}
+		cardList.resize(cardNames.size());
+		vector<Edid> edids(connectorList.size());
+
+		unsigned jobs = cardList.size()+connectorList.size();
+		atomic<unsigned> next(0);
+		auto work = [&](){
+			unsigned i;
+			while((i = next++)<jobs){
+				if(i<cardList.size())
+					probeCard(cardNames[i],cardList[i]);
+				else
+					probeConnector(connectorEntries[i-cardList.size()],connectorList[i-cardList.size()],edids[i-cardList.size()]);
+			}
+		};
+		vector<thread> pool;
+		for(unsigned i=1;i<min(workers,jobs);i++)
+			pool.push_back(thread(work));
+		work();
+		for(unsigned i=0;i<pool.size();i++)
+			pool[i].join();
+
+		model.build(cardList,connectorList,edids);
+		scanTime = now()-start;
+		cout<<LOG_TAG<<" Found "<<cardList.size()<<" cards and "<<connectorList.size()<<" connectors in "<<scanTime<<" ms using "<<pool.size()+1<<" threads"<<endl;
+		return true;
+	}
+
+	const vector<Card> & Detector::cards() const{
+		return cardList;
+	}
+
+	const vector<Connector> & Detector::connectors() const{
+		return connectorList;
+	}
+
+	const Topology & Detector::topology() const{
+		return model;
+	}
+
+	double Detector::scanMillis() const{
+		return scanTime;
+	}
+}
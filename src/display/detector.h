@@ -0,0 +1,50 @@
+#ifndef DETECTOR_H_
+#define DETECTOR_H_
+
+#include "topology.h"
+
+#include<string>
+#include<vector>
+
+namespace Display{
+
+/*! \class Detector
+    \brief DRM cards and connectors as the kernel exports them in sysfs
+
+    Walks class/drm below /sys, or below SAX3_SYSFS_ROOT when set, so a copy
+    of the tree can stand in for the real one. Every cardN-<connector> entry
+    yields its status, enabled state, mode list, raw EDID and vrr_capable
+    (-1 where the kernel does not export it), DisplayPort connectors also
+    the link rate per lane in Mbit/s and the lane count their receiver
+    reports over AUX (0 when unknown), every cardN its
+    PCI ids and the kernel driver bound to it. No X server is involved.
+    Cards are ordered by number, connectors by card and then by name.
+
+    Every card and connector is one job for a pool of up to maxWorkers
+    threads, so connectors whose status or EDID read blocks on the display
+    bus are waited for side by side instead of one after the other. Each
+    job writes only its own slot, EDIDs are decoded in the job as well and
+    the results are merged into topology() once all have finished.
+    */
+	class Detector{
+		std::string root;
+		std::vector<Card> cardList;
+		std::vector<Connector> connectorList;
+		Topology model;
+		unsigned workers;
+		double scanTime;
+		void probeCard(const std::string &name,Card &card) const;
+		void probeConnector(const std::string &entry,Connector &c,Edid &edid) const;
+		void dpLink(const std::string &dir,Connector &c) const;
+		public:
+		Detector(const char * sysfsRoot=NULL,unsigned maxWorkers=8);
+		void setWorkers(unsigned maxWorkers);
+		bool scan();
+		const std::vector<Card> & cards() const;
+		const std::vector<Connector> & connectors() const;
+		const Topology & topology() const;
+		double scanMillis() const;
+	};
+}
+
+#endif
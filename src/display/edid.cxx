@@ -0,0 +1,351 @@
+#include "edid.h"
+#include "modetable.h"
+
+#include<algorithm>
+#include<stdio.h>
+#include<string.h>
+#include<math.h>
+
+using namespace std;
+
+namespace Display{
+
+	/* Active size, nominal rate and scan of an established timing */
+	struct Vic{
+		unsigned short width,height,rate;
+		bool interlaced;
+	};
+
+	/* Established timings I and II, bit 7 of byte 0x23 first */
+	static const Vic established[] = {
+		{720,400,70,false},{720,400,88,false},{640,480,60,false},{640,480,67,false},
+		{640,480,72,false},{640,480,75,false},{800,600,56,false},{800,600,60,false},
+		{800,600,72,false},{800,600,75,false},{832,624,75,false},{1024,768,87,true},
+		{1024,768,60,false},{1024,768,70,false},{1024,768,75,false},{1280,1024,75,false},
+		{1152,870,75,false}
+	};
+
+	static const uint8_t header[8] = {0x00,0xff,0xff,0xff,0xff,0xff,0xff,0x00};
+
+	static bool checksum(const uint8_t * b){
+		uint8_t sum = 0;
+		for(int i=0;i<128;i++)
+			sum += b[i];
+		return sum==0;
+	}
+
+	/* 13 byte text field, ends at LF and is padded with blanks */
+	static string text(const uint8_t * d){
+		string s((const char*)d,13);
+		s = s.substr(0,s.find('\n'));
+		size_t end = s.find_last_not_of(' ');
+		return end==string::npos ? "" : s.substr(0,end+1);
+	}
+
+	static string modeName(const Timing &t){
+		char name[24];
+		snprintf(name,sizeof(name),"%ux%u%s",t.hActive,t.vActive,t.interlaced ? "i" : "");
+		return name;
+	}
+
+	Edid::Edid(){
+		valid = false;
+		product = serial = year = widthCm = heightCm = 0;
+		tmdsClock = 0;
+		memset(&limits,0,sizeof(limits));
+		vrrLow = vrrHigh = 0;
+	}
+
+	bool Edid::parse(const string &blob){
+		return parse((const uint8_t*)blob.data(),blob.size());
+	}
+
+	bool Edid::parse(const uint8_t * b,size_t size){
+		*this = Edid();
+		if(size<128 || memcmp(b,header,8)!=0 || !checksum(b))
+			return false;
+		valid = true;
+		uint16_t id = b[8]<<8 | b[9];
+		vendorId.push_back('@'+(id>>10 & 0x1f));
+		vendorId.push_back('@'+(id>>5 & 0x1f));
+		vendorId.push_back('@'+(id & 0x1f));
+		product = b[10] | b[11]<<8;
+		serial = b[12] | b[13]<<8 | b[14]<<16 | (uint32_t)b[15]<<24;
+		year = b[17]+1990;
+		widthCm = b[21];
+		heightCm = b[22];
+		bool ratio1610 = b[18]>1 || b[19]>=3;
+
+		uint32_t bits = b[0x23]<<16 | b[0x24]<<8 | b[0x25];
+		for(unsigned i=0;i<sizeof(established)/sizeof(established[0]);i++){
+			if(bits & 1u<<(23-i))
+				addMode(established[i].width,established[i].height,established[i].rate,established[i].interlaced,false);
+		}
+		for(int i=0x26;i<0x36;i+=2)
+			standardTiming(b[i],b[i+1],ratio1610);
+		for(int i=0x36;i<0x7e;i+=18)
+			descriptor(b+i);
+
+		size_t blocks = min((size_t)b[0x7e],size/128-1);
+		for(size_t n=1;n<=blocks;n++){
+			const uint8_t * e = b+n*128;
+			if(!checksum(e))
+				continue;
+			if(e[0]==0x02)
+				ceaBlock(e);
+			else if(e[0]==0x70)
+				displayIdBlock(e);
+		}
+
+		if(vrrLow>0 && vrrHigh==0)
+			vrrHigh = limits.maxVRate;
+		if(vrrLow==0 && (b[0x18]&0x01) && limits.maxVRate>limits.minVRate+10){
+			vrrLow = limits.minVRate;
+			vrrHigh = limits.maxVRate;
+		}
+
+		for(unsigned i=0;i<timingList.size();i++){
+			const Timing &t = timingList[i];
+			addMode(t.hActive,t.vActive,t.refresh(),t.interlaced,t.preferred);
+		}
+		stable_sort(modeList.begin(),modeList.end(),[](const Mode &a,const Mode &b){
+			if(a.preferred!=b.preferred)
+				return a.preferred;
+			if(a.width*a.height!=b.width*b.height)
+				return a.width*a.height>b.width*b.height;
+			return a.refresh>b.refresh;
+		});
+		return true;
+	}
+
+	/* 18 byte descriptor of the base block or a CEA extension, a DTD when
+	 * the clock is set. The first DTD of the base block is the preferred
+	 * mode. */
+	void Edid::descriptor(const uint8_t * d){
+		Timing t;
+		if(detailedTiming(d,t)){
+			t.preferred = timingList.empty();
+			timingList.push_back(t);
+			return;
+		}
+		switch(d[3]){
+			case 0xfc:
+				productName = text(d+5);
+				break;
+			case 0xff:
+				serialText = text(d+5);
+				break;
+			case 0xfd:
+				limits.minVRate = d[5] + ((d[4]&0x03)==0x03 ? 255 : 0);
+				limits.maxVRate = d[6] + (d[4]&0x02 ? 255 : 0);
+				limits.minHRate = d[7] + ((d[4]&0x0c)==0x0c ? 255 : 0);
+				limits.maxHRate = d[8] + (d[4]&0x08 ? 255 : 0);
+				limits.maxClock = d[9]*10000;
+				break;
+			case 0xfa:
+				for(int i=5;i<17;i+=2)
+					standardTiming(d[i],d[i+1],true);
+				break;
+		}
+	}
+
+	void Edid::standardTiming(uint8_t a,uint8_t b,bool ratio1610){
+		if(a<=1 && b<=1)
+			return;
+		unsigned w = (a+31)*8,h;
+		switch(b>>6){
+			case 0: h = ratio1610 ? w*10/16 : w; break;
+			case 1: h = w*3/4; break;
+			case 2: h = w*4/5; break;
+			default: h = w*9/16; break;
+		}
+		addMode(w,h,(b&0x3f)+60,false,false);
+	}
+
+	bool Edid::detailedTiming(const uint8_t * d,Timing &t) const{
+		unsigned clock = d[0] | d[1]<<8;
+		if(clock==0)
+			return false;
+		unsigned hActive = d[2] | (d[4]&0xf0)<<4;
+		unsigned hBlank = d[3] | (d[4]&0x0f)<<8;
+		unsigned vActive = d[5] | (d[7]&0xf0)<<4;
+		unsigned vBlank = d[6] | (d[7]&0x0f)<<8;
+		unsigned hOffset = d[8] | (d[11]&0xc0)<<2;
+		unsigned hWidth = d[9] | (d[11]&0x30)<<4;
+		unsigned vOffset = d[10]>>4 | (d[11]&0x0c)<<2;
+		unsigned vWidth = (d[10]&0x0f) | (d[11]&0x03)<<4;
+		t.clock = clock*10;
+		t.interlaced = d[17]&0x80;
+		t.hActive = hActive;
+		t.hSyncStart = hActive+hOffset;
+		t.hSyncEnd = t.hSyncStart+hWidth;
+		t.hTotal = hActive+hBlank;
+		unsigned scale = t.interlaced ? 2 : 1;
+		t.vActive = vActive*scale;
+		t.vSyncStart = t.vActive+vOffset*scale;
+		t.vSyncEnd = t.vSyncStart+vWidth*scale;
+		t.vTotal = (vActive+vBlank)*scale+(t.interlaced ? 1 : 0);
+		bool separate = (d[17]&0x18)==0x18;
+		t.vSyncPositive = separate && (d[17]&0x04);
+		t.hSyncPositive = (d[17]&0x02);
+		t.preferred = false;
+		t.name = modeName(t);
+		return hActive>0 && vActive>0;
+	}
+
+	void Edid::ceaBlock(const uint8_t * b){
+		unsigned dtd = b[2];
+		if(dtd>=4){
+			for(unsigned i=4;i<dtd && i<127;){
+				unsigned tag = b[i]>>5,length = b[i]&0x1f;
+				const uint8_t * p = b+i+1;
+				if(i+1+length>dtd)
+					break;
+				if(tag==2){
+					for(unsigned j=0;j<length;j++){
+						unsigned vic = p[j]>=129 && p[j]<=192 ? p[j]&0x7f : p[j];
+						vicList.push_back(vic);
+						const StandardMode * m = ceaMode(vic);
+						if(m!=NULL)
+							addMode(m->hActive,m->vActive,m->refresh(),m->flags&INTERLACE,false);
+					}
+				}else if(tag==3 && length>=3){
+					uint32_t oui = p[0] | p[1]<<8 | p[2]<<16;
+					unsigned clock = 0;
+					if(oui==0x000c03 && length>=7)
+						clock = p[6]*5000;
+					else if(oui==0xc45dd8 && length>=5)
+						clock = p[4]*5000;
+					/* HF-VSDB bytes 9 and 10 of the block, p starts at byte 1 */
+					if(oui==0xc45dd8 && length>=10 && (p[8]&0x3f)){
+						vrrLow = p[8]&0x3f;
+						vrrHigh = (p[8]&0xc0)<<2 | p[9];
+					}
+					tmdsClock = max(tmdsClock,clock);
+				}
+				i += 1+length;
+			}
+		}
+		if(dtd==0)
+			return;
+		for(unsigned i=dtd;i+18<=127;i+=18){
+			Timing t;
+			if(!detailedTiming(b+i,t))
+				break;
+			timingList.push_back(t);
+		}
+	}
+
+	/* DisplayID section inside an EDID extension. Type I timings count the
+	 * clock in 10 kHz, type VII (DisplayID 2) in kHz, every field is stored
+	 * minus one. */
+	void Edid::displayIdBlock(const uint8_t * b){
+		unsigned end = min(5u+b[2],127u);
+		for(unsigned i=5;i+3<=end;){
+			unsigned tag = b[i],length = b[i+2];
+			const uint8_t * p = b+i+3;
+			if(i+3+length>end)
+				break;
+			if(tag==0x03 || tag==0x22){
+				unsigned unit = tag==0x03 ? 10 : 1;
+				for(unsigned j=0;j+20<=length;j+=20){
+					const uint8_t * d = p+j;
+					Timing t;
+					t.clock = ((d[0] | d[1]<<8 | d[2]<<16)+1)*unit;
+					t.preferred = d[3]&0x80;
+					t.interlaced = d[3]&0x10;
+					t.hActive = (d[4] | d[5]<<8)+1;
+					t.hTotal = t.hActive+(d[6] | d[7]<<8)+1;
+					t.hSyncStart = t.hActive+((d[8] | (d[9]&0x7f)<<8)+1);
+					t.hSyncPositive = d[9]&0x80;
+					t.hSyncEnd = t.hSyncStart+(d[10] | d[11]<<8)+1;
+					t.vActive = (d[12] | d[13]<<8)+1;
+					t.vTotal = t.vActive+(d[14] | d[15]<<8)+1;
+					t.vSyncStart = t.vActive+((d[16] | (d[17]&0x7f)<<8)+1);
+					t.vSyncPositive = d[17]&0x80;
+					t.vSyncEnd = t.vSyncStart+(d[18] | d[19]<<8)+1;
+					t.name = modeName(t);
+					timingList.push_back(t);
+				}
+			}
+			i += 3+length;
+		}
+	}
+
+	void Edid::addMode(unsigned width,unsigned height,double refresh,bool interlaced,bool preferred){
+		for(unsigned i=0;i<modeList.size();i++){
+			Mode &m = modeList[i];
+			if(m.width==width && m.height==height && m.interlaced==interlaced && fabs(m.refresh-refresh)<0.5){
+				m.preferred = m.preferred || preferred;
+				return;
+			}
+		}
+		Mode m;
+		m.width = width;
+		m.height = height;
+		m.refresh = refresh;
+		m.interlaced = interlaced;
+		m.preferred = preferred;
+		modeList.push_back(m);
+	}
+
+	bool Edid::isValid() const{
+		return valid;
+	}
+
+	const string & Edid::vendor() const{
+		return vendorId;
+	}
+
+	const string & Edid::name() const{
+		return productName;
+	}
+
+	const string & Edid::serialNumber() const{
+		return serialText;
+	}
+
+	unsigned Edid::productCode() const{
+		return product;
+	}
+
+	unsigned Edid::manufactureYear() const{
+		return year;
+	}
+
+	unsigned Edid::width() const{
+		return widthCm;
+	}
+
+	unsigned Edid::height() const{
+		return heightCm;
+	}
+
+	const RangeLimits & Edid::range() const{
+		return limits;
+	}
+
+	unsigned Edid::maxTmdsClock() const{
+		return tmdsClock;
+	}
+
+	unsigned Edid::vrrMin() const{
+		return vrrLow;
+	}
+
+	unsigned Edid::vrrMax() const{
+		return vrrHigh;
+	}
+
+	const vector<Timing> & Edid::timings() const{
+		return timingList;
+	}
+
+	const vector<Mode> & Edid::modes() const{
+		return modeList;
+	}
+
+	const vector<unsigned> & Edid::vics() const{
+		return vicList;
+	}
+}
@@ -0,0 +1,75 @@
+#ifndef EDID_H_
+#define EDID_H_
+
+#include "timing.h"
+
+#include<string>
+#include<vector>
+#include<stdint.h>
+
+namespace Display{
+
+	struct Mode{
+		unsigned width,height;
+		double refresh;
+		bool interlaced,preferred;
+	};
+
+	/* Monitor range limits, rates in Hz and kHz, clock in kHz. 0 when the
+	 * EDID does not carry the descriptor. */
+	struct RangeLimits{
+		unsigned minVRate,maxVRate,minHRate,maxHRate,maxClock;
+	};
+
+/*! \class Edid
+    \brief Decoder for EDID 1.x blocks as read from a DRM connector
+
+    Handles the base block, its detailed timing, range limits, name and
+    serial descriptors, established and standard timings, CEA-861
+    extensions (short video descriptors, detailed timings and the HDMI
+    TMDS limit and VRR range) and DisplayID extensions (type I and type VII
+    timings).
+    modes() merges all of them without duplicates, preferred first, then
+    by size and rate. vrrMin() and vrrMax() give the variable refresh range
+    from the HDMI Forum block, else from the range limits of a continuous
+    frequency monitor whose range spans more than 10 Hz, 0 when neither.
+    */
+	class Edid{
+		bool valid;
+		std::string vendorId,productName,serialText;
+		unsigned product,serial,year,widthCm,heightCm;
+		RangeLimits limits;
+		unsigned tmdsClock;
+		unsigned vrrLow,vrrHigh;
+		std::vector<Timing> timingList;
+		std::vector<Mode> modeList;
+		std::vector<unsigned> vicList;
+		void descriptor(const uint8_t * d);
+		void standardTiming(uint8_t a,uint8_t b,bool ratio1610);
+		void ceaBlock(const uint8_t * b);
+		void displayIdBlock(const uint8_t * b);
+		bool detailedTiming(const uint8_t * d,Timing &t) const;
+		void addMode(unsigned width,unsigned height,double refresh,bool interlaced,bool preferred);
+		public:
+		Edid();
+		bool parse(const std::string &blob);
+		bool parse(const uint8_t * data,size_t size);
+		bool isValid() const;
+		const std::string & vendor() const;
+		const std::string & name() const;
+		const std::string & serialNumber() const;
+		unsigned productCode() const;
+		unsigned manufactureYear() const;
+		unsigned width() const;
+		unsigned height() const;
+		const RangeLimits & range() const;
+		unsigned maxTmdsClock() const;
+		unsigned vrrMin() const;
+		unsigned vrrMax() const;
+		const std::vector<Timing> & timings() const;
+		const std::vector<Mode> & modes() const;
+		const std::vector<unsigned> & vics() const;
+	};
+}
+
+#endif
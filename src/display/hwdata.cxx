@@ -0,0 +1,265 @@
+#include "hwdata.h"
+
+#include<iostream>
+#include<algorithm>
+#include<vector>
+#include<stdlib.h>
+#include<string.h>
+#include<time.h>
+#include<fcntl.h>
+#include<sys/stat.h>
+#include<unistd.h>
+
+#define LOG_TAG "[SaX3-Display]"
+#define CACHE_DIR "/var/cache/sax3"
+#define CACHE_MAGIC "SAX3IDS"
+#define CACHE_VERSION 1
+
+using namespace std;
+
+namespace Display{
+
+	enum{VENDORS,DEVICES,MANUFACTURERS,TABLES};
+
+	/* Image layout: Header, then one Entry array per table sorted by key.
+	 * Vendors are keyed by id, devices by vendor<<16|device, manufacturers
+	 * by the three letters of the PNP id. Offsets point into the mapped
+	 * list, pci.ids for the first two tables and pnp.ids for the third. */
+	struct Table{
+		uint32_t offset,count;
+	};
+
+	struct Header{
+		char magic[8];
+		uint32_t version,length;
+		int64_t pciMtime,pnpMtime;
+		uint64_t pciSize,pnpSize;
+		Table tables[TABLES];
+	};
+
+	struct Entry{
+		uint32_t key,offset;
+		bool operator<(const Entry &e) const{
+			return key<e.key;
+		}
+	};
+
+	static double now(){
+		struct timespec ts;
+		clock_gettime(CLOCK_MONOTONIC,&ts);
+		return ts.tv_sec*1000.0 + ts.tv_nsec/1000000.0;
+	}
+
+	/* Value of n hex digits, -1 when one of them is not */
+	static long hex(const char * p,int n){
+		long v = 0;
+		for(int i=0;i<n;i++){
+			int d = p[i]>='0' && p[i]<='9' ? p[i]-'0' : p[i]>='a' && p[i]<='f' ? p[i]-'a'+10 : p[i]>='A' && p[i]<='F' ? p[i]-'A'+10 : -1;
+			if(d<0)
+				return -1;
+			v = v<<4 | d;
+		}
+		return v;
+	}
+
+	static uint32_t pnpKey(const char * id){
+		return (uint8_t)id[0]<<16 | (uint8_t)id[1]<<8 | (uint8_t)id[2];
+	}
+
+	static const char * firstOf(const char * const * paths){
+		for(int i=0;paths[i]!=NULL;i++){
+			if(access(paths[i],R_OK)==0)
+				return paths[i];
+		}
+		return paths[0];
+	}
+
+	HwData::HwData(const char * pciIds,const char * pnpIds,const char * cacheDir){
+		static const char * const pciPaths[] = {"/usr/share/hwdata/pci.ids","/usr/share/misc/pci.ids","/usr/share/pci.ids",NULL};
+		static const char * const pnpPaths[] = {"/usr/share/hwdata/pnp.ids","/usr/share/misc/pnp.ids",NULL};
+		base = NULL;
+		cached = false;
+		loadTime = 0;
+		if(cacheDir==NULL)
+			cacheDir = getenv("SAX3_CACHE_DIR");
+		pciPath = pciIds!=NULL ? pciIds : firstOf(pciPaths);
+		pnpPath = pnpIds!=NULL ? pnpIds : firstOf(pnpPaths);
+		cachePath = string(cacheDir!=NULL ? cacheDir : CACHE_DIR)+"/hwdata.cache";
+
+		double start = now();
+		if(!pci.open(pciPath))
+			cerr<<LOG_TAG<<" Cannot open "<<pciPath<<endl;
+		if(!pnp.open(pnpPath))
+			cerr<<LOG_TAG<<" Cannot open "<<pnpPath<<endl;
+		if(!pci.isOpen() && !pnp.isOpen())
+			return;
+		if(cache.open(cachePath) && accept(cache.data(),cache.size())){
+			base = cache.data();
+			cached = true;
+		}
+		else{
+			cache.close();
+			image = compile();
+			base = image.data();
+			store(image);
+		}
+		loadTime = now()-start;
+		cout<<LOG_TAG<<" "<<(cached ? "Mapped cached" : "Indexed")<<" hardware names in "<<loadTime<<" ms"<<endl;
+	}
+
+	/* Besides the stamps of both lists, every table has to lie inside the
+	 * image, be sorted for the binary search and point into the list it
+	 * indexes, so find() never reads past either mapping. */
+	bool HwData::accept(const char * data,size_t size) const{
+		if(size<sizeof(Header))
+			return false;
+		const Header * h = (const Header*)data;
+		if(memcmp(h->magic,CACHE_MAGIC,8) || h->version!=CACHE_VERSION || h->length!=size ||
+				h->pciMtime!=(int64_t)pci.mtime() || h->pciSize!=(uint64_t)pci.size() ||
+				h->pnpMtime!=(int64_t)pnp.mtime() || h->pnpSize!=(uint64_t)pnp.size())
+			return false;
+		for(int t=0;t<TABLES;t++){
+			const Table &table = h->tables[t];
+			if(table.offset<sizeof(Header) || table.offset%4!=0 || table.offset>size || table.count>(size-table.offset)/sizeof(Entry))
+				return false;
+			size_t listSize = t==MANUFACTURERS ? pnp.size() : pci.size();
+			const Entry * entries = (const Entry*)(data+table.offset);
+			for(uint32_t i=0;i<table.count;i++){
+				if(entries[i].offset>=listSize || (i>0 && entries[i].key<entries[i-1].key))
+					return false;
+			}
+		}
+		return true;
+	}
+
+	/* One pass over each list. pci.ids has vendors at the start of a line,
+	 * their devices indented by one tab and subsystems by two; the device
+	 * classes after the first "C " line are not needed. pnp.ids has one
+	 * "ABC<tab>Name" per line. */
+	string HwData::compile() const{
+		vector<Entry> tables[TABLES];
+		const char * p = pci.data(),* end = p+pci.size();
+		long vendor = -1;
+		while(p<end){
+			const char * eol = (const char*)memchr(p,'\n',end-p);
+			if(eol==NULL)
+				eol = end;
+			size_t n = eol-p;
+			if(n>=2 && p[0]=='C' && p[1]==' ')
+				break;
+			Entry e;
+			if(n>6 && p[0]!='\t' && p[0]!='#' && (vendor = hex(p,4))>=0 && p[4]==' '){
+				e.key = vendor;
+				e.offset = p+6-pci.data();
+				tables[VENDORS].push_back(e);
+			}else if(n>7 && vendor>=0 && p[0]=='\t' && p[1]!='\t' && p[5]==' '){
+				long device = hex(p+1,4);
+				if(device>=0){
+					e.key = vendor<<16 | device;
+					e.offset = p+7-pci.data();
+					tables[DEVICES].push_back(e);
+				}
+			}
+			p = eol+1;
+		}
+		p = pnp.data();
+		end = p+pnp.size();
+		while(p<end){
+			const char * eol = (const char*)memchr(p,'\n',end-p);
+			if(eol==NULL)
+				eol = end;
+			if(eol-p>4 && p[3]=='\t' && p[0]!='#'){
+				Entry e;
+				e.key = pnpKey(p);
+				e.offset = p+4-pnp.data();
+				tables[MANUFACTURERS].push_back(e);
+			}
+			p = eol+1;
+		}
+
+		Header h;
+		memset(&h,0,sizeof(h));
+		memcpy(h.magic,CACHE_MAGIC,8);
+		h.version = CACHE_VERSION;
+		h.pciMtime = pci.mtime();
+		h.pciSize = pci.size();
+		h.pnpMtime = pnp.mtime();
+		h.pnpSize = pnp.size();
+		uint32_t offset = sizeof(Header);
+		for(int t=0;t<TABLES;t++){
+			stable_sort(tables[t].begin(),tables[t].end());
+			h.tables[t].offset = offset;
+			h.tables[t].count = tables[t].size();
+			offset += tables[t].size()*sizeof(Entry);
+		}
+		h.length = offset;
+		string image((const char*)&h,sizeof(h));
+		for(int t=0;t<TABLES;t++)
+			image.append((const char*)tables[t].data(),tables[t].size()*sizeof(Entry));
+		return image;
+	}
+
+	/* Keep the index for the next start. An unwritable cache directory
+	 * only costs the next start a pass over the lists. */
+	void HwData::store(const string &image) const{
+		string dir = cachePath.substr(0,cachePath.rfind('/'));
+		mkdir(dir.c_str(),0755);
+		string tmp = cachePath+".XXXXXX";
+		vector<char> name(tmp.begin(),tmp.end());
+		name.push_back('\0');
+		int fd = mkstemp(name.data());
+		if(fd==-1)
+			return;
+		fchmod(fd,0644);
+		bool ok = write(fd,image.data(),image.size())==(ssize_t)image.size();
+		ok = close(fd)==0 && ok;
+		if(!ok || rename(name.data(),cachePath.c_str())==-1){
+			unlink(name.data());
+			cerr<<LOG_TAG<<" Cannot write "<<cachePath<<endl;
+		}
+	}
+
+	string HwData::find(int table,uint32_t key) const{
+		if(base==NULL)
+			return "";
+		const Header * h = (const Header*)base;
+		const Entry * first = (const Entry*)(base+h->tables[table].offset);
+		const Entry * last = first+h->tables[table].count;
+		Entry e;
+		e.key = key;
+		const Entry * i = lower_bound(first,last,e);
+		if(i==last || i->key!=key)
+			return "";
+		const Util::MappedFile &list = table==MANUFACTURERS ? pnp : pci;
+		const char * name = list.data()+i->offset;
+		const char * stop = name;
+		const char * end = list.data()+list.size();
+		while(stop<end && *stop!='\n' && *stop!='\r')
+			stop++;
+		return string(name,stop-name);
+	}
+
+	bool HwData::isLoaded() const{
+		return base!=NULL;
+	}
+
+	bool HwData::fromCache() const{
+		return cached;
+	}
+
+	double HwData::loadMillis() const{
+		return loadTime;
+	}
+
+	string HwData::vendor(unsigned vendor) const{
+		return find(VENDORS,vendor);
+	}
+
+	string HwData::device(unsigned vendor,unsigned device) const{
+		return find(DEVICES,vendor<<16 | device);
+	}
+
+	string HwData::manufacturer(const string &pnpId) const{
+		return pnpId.size()==3 ? find(MANUFACTURERS,pnpKey(pnpId.c_str())) : "";
+	}
+}
@@ -0,0 +1,46 @@
+#ifndef HWDATA_H_
+#define HWDATA_H_
+
+#include "../util/mappedfile.h"
+
+#include<string>
+#include<stdint.h>
+
+namespace Display{
+
+/*! \class HwData
+    \brief Vendor and device names from pci.ids, manufacturer names from pnp.ids
+
+    Both lists stay mapped and are never copied. Lookups go through an
+    index of sorted (id, offset) pairs, the offset being where the name
+    starts in the mapped text, so a name costs a binary search and one
+    short copy. The index is built once and kept in SAX3_CACHE_DIR
+    (/var/cache/sax3 by default) together with mtime and size of both
+    lists, and is rebuilt once either of them changes. Unknown ids give an
+    empty string.
+    */
+	class HwData{
+		Util::MappedFile pci,pnp,cache;
+		std::string image;
+		const char * base;
+		std::string pciPath,pnpPath,cachePath;
+		bool cached;
+		double loadTime;
+		bool accept(const char * data,size_t size) const;
+		std::string compile() const;
+		void store(const std::string &data) const;
+		std::string find(int table,uint32_t key) const;
+		HwData(const HwData &);
+		HwData & operator=(const HwData &);
+		public:
+		HwData(const char * pciIds=NULL,const char * pnpIds=NULL,const char * cacheDir=NULL);
+		bool isLoaded() const;
+		bool fromCache() const;
+		double loadMillis() const;
+		std::string vendor(unsigned vendor) const;
+		std::string device(unsigned vendor,unsigned device) const;
+		std::string manufacturer(const std::string &pnpId) const;
+	};
+}
+
+#endif
@@ -0,0 +1,231 @@
+#include "layout.h"
+#include "modetable.h"
+#include "cvt.h"
+
+#include<iostream>
+#include<algorithm>
+#include<stdio.h>
+#include<stdlib.h>
+#include<string.h>
+
+#define LOG_TAG "[SaX3-Display]"
+
+using namespace std;
+
+namespace Display{
+
+	Layout::Layout(){
+		anchorGpu = 0;
+		width = height = 0;
+	}
+
+	/* Preferred EDID mode, else the kernel's first mode at 60 Hz */
+	static Timing preferredTiming(const Output &o){
+		if(o.decoded && !o.edid.modes().empty()){
+			const Mode &m = o.edid.modes()[0];
+			return modeTiming(o.edid,m.width,m.height,m.refresh,m.interlaced);
+		}
+		unsigned w,h;
+		if(!o.connector.modes.empty() && sscanf(o.connector.modes[0].c_str(),"%ux%u",&w,&h)==2)
+			return modeTiming(o.edid,w,h,60);
+		return cvt(1024,768);
+	}
+
+	void Layout::build(const Topology &topology){
+		list.clear();
+		cards.clear();
+		const vector<Gpu> &gpus = topology.gpus();
+		const Output * primary = topology.primary();
+		for(unsigned i=0;i<gpus.size();i++){
+			cards.push_back(gpus[i].card);
+			for(unsigned j=0;j<gpus[i].outputs.size();j++){
+				const Output &o = gpus[i].outputs[j];
+				if(o.connector.status!=CONNECTED)
+					continue;
+				Placement p;
+				p.output = o.connector.name;
+				p.gpu = i;
+				p.mode = preferredTiming(o);
+				p.relation = RIGHT_OF;
+				p.relativeTo = -1;
+				p.x = p.y = 0;
+				p.rotation = NORMAL;
+				p.primary = &o==primary;
+				if(p.primary)
+					list.insert(list.begin(),p);
+				else
+					list.push_back(p);
+			}
+		}
+		anchorGpu = list.empty() ? 0 : list[0].gpu;
+		for(unsigned i=0;i<list.size();i++){
+			if(i==0)
+				list[i].relation = ORIGIN;
+			else
+				list[i].relativeTo = i-1;
+		}
+		arrange();
+	}
+
+	vector<Placement> & Layout::placements(){
+		return list;
+	}
+
+	const vector<Placement> & Layout::placements() const{
+		return list;
+	}
+
+	/* Outputs are placed once what they refer to is, which takes at most
+	 * as many rounds as there are outputs. Whatever is left refers to a
+	 * switched off or unknown output or is part of a cycle. */
+	bool Layout::arrange(){
+		unsigned n = list.size();
+		vector<bool> placed(n,false);
+		vector<int> w(n),h(n);
+		for(unsigned i=0;i<n;i++){
+			Placement &p = list[i];
+			bool turned = p.rotation==LEFT || p.rotation==RIGHT;
+			w[i] = turned ? p.mode.vActive : p.mode.hActive;
+			h[i] = turned ? p.mode.hActive : p.mode.vActive;
+			if(p.relation==ORIGIN)
+				p.x = p.y = 0;
+			placed[i] = p.relation==ORIGIN || p.relation==ABSOLUTE || p.relation==OFF;
+		}
+		bool progress = true;
+		while(progress){
+			progress = false;
+			for(unsigned i=0;i<n;i++){
+				if(placed[i])
+					continue;
+				int r = list[i].relativeTo;
+				if(r<0 || r>=(int)n || !placed[r] || list[r].relation==OFF)
+					continue;
+				Placement &p = list[i],&ref = list[r];
+				switch(p.relation){
+					case RIGHT_OF: p.x = ref.x+w[r]; p.y = ref.y; break;
+					case LEFT_OF: p.x = ref.x-w[i]; p.y = ref.y; break;
+					case ABOVE: p.x = ref.x; p.y = ref.y-h[i]; break;
+					default: p.x = ref.x; p.y = ref.y+h[r]; break;
+				}
+				placed[i] = progress = true;
+			}
+		}
+		int left = 0,top = 0;
+		bool first = true;
+		for(unsigned i=0;i<n;i++){
+			if(!placed[i]){
+				cerr<<LOG_TAG<<" Cannot place "<<label(list[i])<<endl;
+				return false;
+			}
+			if(list[i].relation==OFF)
+				continue;
+			if(first || list[i].x<left)
+				left = list[i].x;
+			if(first || list[i].y<top)
+				top = list[i].y;
+			first = false;
+		}
+		width = height = 0;
+		for(unsigned i=0;i<n;i++){
+			if(list[i].relation==OFF)
+				continue;
+			list[i].x -= left;
+			list[i].y -= top;
+			width = max(width,list[i].x+w[i]);
+			height = max(height,list[i].y+h[i]);
+		}
+		return true;
+	}
+
+	int Layout::virtualWidth() const{
+		return width;
+	}
+
+	int Layout::virtualHeight() const{
+		return height;
+	}
+
+	unsigned Layout::primaryGpu() const{
+		return anchorGpu;
+	}
+
+	const vector<Card> & Layout::gpus() const{
+		return cards;
+	}
+
+	string Layout::label(const Placement &p) const{
+		return cards.size()>1 ? cards[p.gpu].name+"-"+p.output : p.output;
+	}
+
+	string Layout::monitorName(const Placement &p) const{
+		if(!list.empty() && p.gpu==list[0].gpu && p.output==list[0].output)
+			return "SaX3-monitor";
+		return "SaX3-monitor-"+cards[p.gpu].name+"-"+p.output;
+	}
+
+	string Layout::deviceName(unsigned gpu) const{
+		return gpu==anchorGpu ? "SaX3-device" : "SaX3-device-"+cards[gpu].name;
+	}
+
+	/* Kernel connectors are TYPE-N. modesetting calls HDMI-A plain HDMI,
+	 * intel drops the dash, amdgpu, radeon and nvidia count from 0 and the
+	 * first two spell DP out. Outputs of a card that joins as a GPU screen
+	 * carry the number of that card among the others: DP-1-2. */
+	string Layout::xorgOutput(const Placement &p,const string &driver) const{
+		size_t dash = p.output.rfind('-');
+		if(dash==string::npos)
+			return p.output;
+		string type = p.output.substr(0,dash);
+		int n = atoi(p.output.c_str()+dash+1);
+		bool ati = driver=="amdgpu" || driver=="radeon";
+		if(type=="HDMI-A" && !ati)
+			type = "HDMI";
+		if(type=="DP" && ati)
+			type = "DisplayPort";
+		if(ati || driver=="nvidia")
+			n--;
+		if(ati && type=="eDP")
+			return type;
+		char name[64];
+		if(p.gpu!=anchorGpu){
+			unsigned k = 1;
+			for(unsigned g=0;g<p.gpu;g++){
+				if(g!=anchorGpu)
+					k++;
+			}
+			snprintf(name,sizeof(name),"%s-%u-%d",type.c_str(),k,n);
+		}else{
+			snprintf(name,sizeof(name),driver=="intel" ? "%s%d" : "%s-%d",type.c_str(),n);
+		}
+		return name;
+	}
+
+	/* 0000:01:00.0 as Xorg writes it, PCI:1:0:0 with decimal numbers */
+	string Layout::busId(const Card &card){
+		unsigned domain,bus,device,function;
+		if(sscanf(card.busId.c_str(),"%x:%x:%x.%x",&domain,&bus,&device,&function)!=4)
+			return "";
+		char id[40];
+		if(domain)
+			snprintf(id,sizeof(id),"PCI:%u@%u:%u:%u",bus,domain,device,function);
+		else
+			snprintf(id,sizeof(id),"PCI:%u:%u:%u",bus,device,function);
+		return id;
+	}
+
+	const char * Layout::relationOption(Relation relation){
+		switch(relation){
+			case RIGHT_OF: return "RightOf";
+			case LEFT_OF: return "LeftOf";
+			case ABOVE: return "Above";
+			case BELOW: return "Below";
+			case ABSOLUTE: return "Position";
+			default: return NULL;
+		}
+	}
+
+	const char * Layout::rotationValue(Rotation rotation){
+		static const char * values[] = {"normal","left","right","inverted"};
+		return values[rotation];
+	}
+}
@@ -0,0 +1,72 @@
+#ifndef LAYOUT_H_
+#define LAYOUT_H_
+
+#include "topology.h"
+#include "timing.h"
+
+#include<string>
+#include<vector>
+
+namespace Display{
+
+	enum Relation{ORIGIN,RIGHT_OF,LEFT_OF,ABOVE,BELOW,ABSOLUTE,OFF};
+	enum Rotation{NORMAL,LEFT,RIGHT,INVERTED};
+
+	/* Where one output goes. relativeTo is the index of another placement
+	 * for the relative relations, x and y are the requested position for
+	 * ABSOLUTE and the resolved one of every output after arrange(). */
+	struct Placement{
+		std::string output;
+		unsigned gpu;
+		Timing mode;
+		Relation relation;
+		int relativeTo;
+		int x,y;
+		Rotation rotation;
+		bool primary;
+	};
+
+/*! \class Layout
+    \brief Placement of every connected output across all cards
+
+    Starts from a topology with each connected output in its preferred
+    mode. The primary output sits at the origin, the others follow it
+    left to right in topology order. The caller changes placements,
+    modes, rotations and the primary output. arrange() then resolves the
+    relations into positions, with rotation swapping width and height,
+    and moves the whole layout so it starts at 0,0.
+
+    label() is the connector name, prefixed with its card as in sysfs once
+    there is more than one card. The card of the first placement keeps
+    SaX3-device and the output itself keeps SaX3-monitor, so a single head
+    setup keeps the sections it always had. Every other card and output
+    gets a section name of its own. xorgOutput() gives the name the
+    Xorg driver uses for a connector, which the Monitor-<output> options
+    of a Device section refer to.
+    */
+	class Layout{
+		std::vector<Placement> list;
+		std::vector<Card> cards;
+		unsigned anchorGpu;
+		int width,height;
+		public:
+		Layout();
+		void build(const Topology &topology);
+		std::vector<Placement> & placements();
+		const std::vector<Placement> & placements() const;
+		bool arrange();
+		int virtualWidth() const;
+		int virtualHeight() const;
+		unsigned primaryGpu() const;
+		const std::vector<Card> & gpus() const;
+		std::string label(const Placement &p) const;
+		std::string monitorName(const Placement &p) const;
+		std::string deviceName(unsigned gpu) const;
+		std::string xorgOutput(const Placement &p,const std::string &driver) const;
+		static std::string busId(const Card &card);
+		static const char * relationOption(Relation relation);
+		static const char * rotationValue(Rotation rotation);
+	};
+}
+
+#endif
@@ -0,0 +1,52 @@
+#include "modetable.h"
+#include "edid.h"
+#include "cvt.h"
+
+#include<math.h>
+
+using namespace std;
+
+namespace Display{
+
+	static_assert(standardModes[ceaFirst-1].source==DMT && standardModes[ceaFirst].source==CEA && standardModes[ceaFirst].id==1,"CEA part of the table starts at VIC 1");
+	static_assert(standardModeCount==ceaFirst+ceaLast,"one entry per VIC");
+	static_assert(ceaMode(16)->clock==148500 && ceaMode(97)->hActive==3840,"VIC lookup");
+	static_assert(findStandardMode(1920,1080,60)->source==DMT,"DMT is preferred over CEA");
+	static_assert(findStandardMode(1024,768,75)->clock==78750,"closest rate wins");
+	static_assert(findStandardMode(1024,768,65)==NULL,"no match outside half a hertz");
+
+	Timing standardTiming(const StandardMode &mode){
+		Timing t;
+		t.clock = mode.clock;
+		t.hActive = mode.hActive;
+		t.hSyncStart = mode.hSyncStart;
+		t.hSyncEnd = mode.hSyncEnd;
+		t.hTotal = mode.hTotal;
+		t.vActive = mode.vActive;
+		t.vSyncStart = mode.vSyncStart;
+		t.vSyncEnd = mode.vSyncEnd;
+		t.vTotal = mode.vTotal;
+		t.interlaced = mode.flags&INTERLACE;
+		t.hSyncPositive = mode.flags&PHSYNC;
+		t.vSyncPositive = mode.flags&PVSYNC;
+		t.preferred = false;
+		t.name = t.rateName();
+		return t;
+	}
+
+	Timing modeTiming(const Edid &edid,unsigned width,unsigned height,double rate,bool interlaced){
+		const vector<Timing> &timings = edid.timings();
+		for(unsigned i=0;i<timings.size();i++){
+			const Timing &t = timings[i];
+			if(t.hActive==width && t.vActive==height && t.interlaced==interlaced && fabs(t.refresh()-rate)<0.5){
+				Timing own = t;
+				own.name = own.rateName();
+				return own;
+			}
+		}
+		const StandardMode * standard = findStandardMode(width,height,rate,interlaced);
+		if(standard!=NULL)
+			return standardTiming(*standard);
+		return cvt(width,height,rate,STANDARD,interlaced);
+	}
+}
@@ -0,0 +1,261 @@
+#ifndef MODETABLE_H_
+#define MODETABLE_H_
+
+#include "timing.h"
+
+namespace Display{
+
+	enum ModeSource{DMT,CEA};
+	enum ModeFlags{PHSYNC=1,PVSYNC=2,INTERLACE=4};
+
+	struct StandardMode{
+		unsigned char source,id;
+		unsigned clock;
+		unsigned short hActive,hSyncStart,hSyncEnd,hTotal;
+		unsigned short vActive,vSyncStart,vSyncEnd,vTotal;
+		unsigned char flags;
+		constexpr double refresh() const{
+			return clock*1000.0/((double)hTotal*vTotal)*(flags&INTERLACE ? 2 : 1);
+		}
+	};
+
+	/* VESA DMT 1.0 r13 by DMT id, then CEA-861-F VICs 1 to 107 in VIC
+	 * order. Pixel repeated VICs are given at their repeated width. */
+	inline constexpr StandardMode standardModes[] = {
+		{DMT,0x01,31500,640,672,736,832,350,382,385,445,PHSYNC},
+		{DMT,0x02,31500,640,672,736,832,400,401,404,445,PVSYNC},
+		{DMT,0x03,35500,720,756,828,936,400,401,404,446,PVSYNC},
+		{DMT,0x04,25175,640,656,752,800,480,490,492,525,0},
+		{DMT,0x05,31500,640,664,704,832,480,489,492,520,0},
+		{DMT,0x06,31500,640,656,720,840,480,481,484,500,0},
+		{DMT,0x07,36000,640,696,752,832,480,481,484,509,0},
+		{DMT,0x08,36000,800,824,896,1024,600,601,603,625,PHSYNC|PVSYNC},
+		{DMT,0x09,40000,800,840,968,1056,600,601,605,628,PHSYNC|PVSYNC},
+		{DMT,0x0a,50000,800,856,976,1040,600,637,643,666,PHSYNC|PVSYNC},
+		{DMT,0x0b,49500,800,816,896,1056,600,601,604,625,PHSYNC|PVSYNC},
+		{DMT,0x0c,56250,800,832,896,1048,600,601,604,631,PHSYNC|PVSYNC},
+		{DMT,0x0d,73250,800,848,880,960,600,603,607,636,PHSYNC},
+		{DMT,0x0e,33750,848,864,976,1088,480,486,494,517,PHSYNC|PVSYNC},
+		{DMT,0x0f,44900,1024,1032,1208,1264,768,768,776,817,PHSYNC|PVSYNC|INTERLACE},
+		{DMT,0x10,65000,1024,1048,1184,1344,768,771,777,806,0},
+		{DMT,0x11,75000,1024,1048,1184,1328,768,771,777,806,0},
+		{DMT,0x12,78750,1024,1040,1136,1312,768,769,772,800,PHSYNC|PVSYNC},
+		{DMT,0x13,94500,1024,1072,1168,1376,768,769,772,808,PHSYNC|PVSYNC},
+		{DMT,0x14,115500,1024,1072,1104,1184,768,771,775,813,PHSYNC},
+		{DMT,0x15,108000,1152,1216,1344,1600,864,865,868,900,PHSYNC|PVSYNC},
+		{DMT,0x55,74250,1280,1390,1430,1650,720,725,730,750,PHSYNC|PVSYNC},
+		{DMT,0x16,68250,1280,1328,1360,1440,768,771,778,790,PHSYNC},
+		{DMT,0x17,79500,1280,1344,1472,1664,768,771,778,798,PVSYNC},
+		{DMT,0x18,102250,1280,1360,1488,1696,768,771,778,805,PVSYNC},
+		{DMT,0x19,117500,1280,1360,1496,1712,768,771,778,809,PVSYNC},
+		{DMT,0x1a,140250,1280,1328,1360,1440,768,771,778,813,PHSYNC},
+		{DMT,0x1b,71000,1280,1328,1360,1440,800,803,809,823,PHSYNC},
+		{DMT,0x1c,83500,1280,1352,1480,1680,800,803,809,831,PVSYNC},
+		{DMT,0x1d,106500,1280,1360,1488,1696,800,803,809,838,PVSYNC},
+		{DMT,0x1e,122500,1280,1360,1496,1712,800,803,809,843,PVSYNC},
+		{DMT,0x1f,146250,1280,1328,1360,1440,800,803,809,847,PHSYNC},
+		{DMT,0x20,108000,1280,1376,1488,1800,960,961,964,1000,PHSYNC|PVSYNC},
+		{DMT,0x21,148500,1280,1344,1504,1728,960,961,964,1011,PHSYNC|PVSYNC},
+		{DMT,0x22,175500,1280,1328,1360,1440,960,963,967,1017,PHSYNC},
+		{DMT,0x23,108000,1280,1328,1440,1688,1024,1025,1028,1066,PHSYNC|PVSYNC},
+		{DMT,0x24,135000,1280,1296,1440,1688,1024,1025,1028,1066,PHSYNC|PVSYNC},
+		{DMT,0x25,157500,1280,1344,1504,1728,1024,1025,1028,1072,PHSYNC|PVSYNC},
+		{DMT,0x26,187250,1280,1328,1360,1440,1024,1027,1034,1084,PHSYNC},
+		{DMT,0x27,85500,1360,1424,1536,1792,768,771,777,795,PHSYNC|PVSYNC},
+		{DMT,0x28,148250,1360,1408,1440,1520,768,771,776,813,PHSYNC},
+		{DMT,0x51,85500,1366,1436,1579,1792,768,771,774,798,PHSYNC|PVSYNC},
+		{DMT,0x56,72000,1366,1380,1436,1500,768,769,772,800,PHSYNC|PVSYNC},
+		{DMT,0x29,101000,1400,1448,1480,1560,1050,1053,1057,1080,PHSYNC},
+		{DMT,0x2a,121750,1400,1488,1632,1864,1050,1053,1057,1089,PVSYNC},
+		{DMT,0x2b,156000,1400,1504,1648,1896,1050,1053,1057,1099,PVSYNC},
+		{DMT,0x2c,179500,1400,1504,1656,1912,1050,1053,1057,1105,PVSYNC},
+		{DMT,0x2d,208000,1400,1448,1480,1560,1050,1053,1057,1112,PHSYNC},
+		{DMT,0x2e,88750,1440,1488,1520,1600,900,903,909,926,PHSYNC},
+		{DMT,0x2f,106500,1440,1520,1672,1904,900,903,909,934,PVSYNC},
+		{DMT,0x30,136750,1440,1536,1688,1936,900,903,909,942,PVSYNC},
+		{DMT,0x31,157000,1440,1544,1696,1952,900,903,909,948,PVSYNC},
+		{DMT,0x32,182750,1440,1488,1520,1600,900,903,909,953,PHSYNC},
+		{DMT,0x53,108000,1600,1624,1704,1800,900,901,904,1000,PHSYNC|PVSYNC},
+		{DMT,0x33,162000,1600,1664,1856,2160,1200,1201,1204,1250,PHSYNC|PVSYNC},
+		{DMT,0x34,175500,1600,1664,1856,2160,1200,1201,1204,1250,PHSYNC|PVSYNC},
+		{DMT,0x35,189000,1600,1664,1856,2160,1200,1201,1204,1250,PHSYNC|PVSYNC},
+		{DMT,0x36,202500,1600,1664,1856,2160,1200,1201,1204,1250,PHSYNC|PVSYNC},
+		{DMT,0x37,229500,1600,1664,1856,2160,1200,1201,1204,1250,PHSYNC|PVSYNC},
+		{DMT,0x38,268250,1600,1648,1680,1760,1200,1203,1207,1271,PHSYNC},
+		{DMT,0x39,119000,1680,1728,1760,1840,1050,1053,1059,1080,PHSYNC},
+		{DMT,0x3a,146250,1680,1784,1960,2240,1050,1053,1059,1089,PVSYNC},
+		{DMT,0x3b,187000,1680,1800,1976,2272,1050,1053,1059,1099,PVSYNC},
+		{DMT,0x3c,214750,1680,1808,1984,2288,1050,1053,1059,1105,PVSYNC},
+		{DMT,0x3d,245500,1680,1728,1760,1840,1050,1053,1059,1112,PHSYNC},
+		{DMT,0x3e,204750,1792,1920,2120,2448,1344,1345,1348,1394,PVSYNC},
+		{DMT,0x3f,261000,1792,1888,2104,2456,1344,1345,1348,1417,PVSYNC},
+		{DMT,0x40,333250,1792,1840,1872,1952,1344,1347,1351,1423,PHSYNC},
+		{DMT,0x41,218250,1856,1952,2176,2528,1392,1393,1396,1439,PVSYNC},
+		{DMT,0x42,288000,1856,1984,2208,2560,1392,1393,1396,1500,PVSYNC},
+		{DMT,0x43,356500,1856,1904,1936,2016,1392,1395,1399,1474,PHSYNC},
+		{DMT,0x52,148500,1920,2008,2052,2200,1080,1084,1089,1125,PHSYNC|PVSYNC},
+		{DMT,0x44,154000,1920,1968,2000,2080,1200,1203,1209,1235,PHSYNC},
+		{DMT,0x45,193250,1920,2056,2256,2592,1200,1203,1209,1245,PVSYNC},
+		{DMT,0x46,245250,1920,2056,2264,2608,1200,1203,1209,1255,PVSYNC},
+		{DMT,0x47,281250,1920,2064,2272,2624,1200,1203,1209,1262,PVSYNC},
+		{DMT,0x48,317000,1920,1968,2000,2080,1200,1203,1209,1271,PHSYNC},
+		{DMT,0x49,234000,1920,2048,2256,2600,1440,1441,1444,1500,PVSYNC},
+		{DMT,0x4a,297000,1920,2064,2288,2640,1440,1441,1444,1500,PVSYNC},
+		{DMT,0x4b,380500,1920,1968,2000,2080,1440,1443,1447,1525,PHSYNC},
+		{DMT,0x54,162000,2048,2074,2154,2250,1152,1153,1156,1200,PHSYNC|PVSYNC},
+		{DMT,0x4c,268500,2560,2608,2640,2720,1600,1603,1609,1646,PHSYNC},
+		{DMT,0x4d,348500,2560,2752,3032,3504,1600,1603,1609,1658,PVSYNC},
+		{DMT,0x4e,443250,2560,2768,3048,3536,1600,1603,1609,1672,PVSYNC},
+		{DMT,0x4f,505250,2560,2768,3048,3536,1600,1603,1609,1682,PVSYNC},
+		{DMT,0x50,552750,2560,2608,2640,2720,1600,1603,1609,1694,PHSYNC},
+		{DMT,0x57,556744,4096,4104,4136,4176,2160,2208,2216,2222,PHSYNC},
+		{DMT,0x58,556188,4096,4104,4136,4176,2160,2208,2216,2222,PHSYNC},
+
+		{CEA,1,25175,640,656,752,800,480,490,492,525,0},
+		{CEA,2,27000,720,736,798,858,480,489,495,525,0},
+		{CEA,3,27000,720,736,798,858,480,489,495,525,0},
+		{CEA,4,74250,1280,1390,1430,1650,720,725,730,750,PHSYNC|PVSYNC},
+		{CEA,5,74250,1920,2008,2052,2200,1080,1084,1094,1125,PHSYNC|PVSYNC|INTERLACE},
+		{CEA,6,27000,1440,1478,1602,1716,480,488,494,525,INTERLACE},
+		{CEA,7,27000,1440,1478,1602,1716,480,488,494,525,INTERLACE},
+		{CEA,8,27000,1440,1478,1602,1716,240,244,247,262,0},
+		{CEA,9,27000,1440,1478,1602,1716,240,244,247,262,0},
+		{CEA,10,54000,2880,2956,3204,3432,480,488,494,525,INTERLACE},
+		{CEA,11,54000,2880,2956,3204,3432,480,488,494,525,INTERLACE},
+		{CEA,12,54000,2880,2956,3204,3432,240,244,247,262,0},
+		{CEA,13,54000,2880,2956,3204,3432,240,244,247,262,0},
+		{CEA,14,54000,1440,1472,1596,1716,480,489,495,525,0},
+		{CEA,15,54000,1440,1472,1596,1716,480,489,495,525,0},
+		{CEA,16,148500,1920,2008,2052,2200,1080,1084,1089,1125,PHSYNC|PVSYNC},
+		{CEA,17,27000,720,732,796,864,576,581,586,625,0},
+		{CEA,18,27000,720,732,796,864,576,581,586,625,0},
+		{CEA,19,74250,1280,1720,1760,1980,720,725,730,750,PHSYNC|PVSYNC},
+		{CEA,20,74250,1920,2448,2492,2640,1080,1084,1094,1125,PHSYNC|PVSYNC|INTERLACE},
+		{CEA,21,27000,1440,1464,1590,1728,576,580,586,625,INTERLACE},
+		{CEA,22,27000,1440,1464,1590,1728,576,580,586,625,INTERLACE},
+		{CEA,23,27000,1440,1464,1590,1728,288,290,293,312,0},
+		{CEA,24,27000,1440,1464,1590,1728,288,290,293,312,0},
+		{CEA,25,54000,2880,2928,3180,3456,576,580,586,625,INTERLACE},
+		{CEA,26,54000,2880,2928,3180,3456,576,580,586,625,INTERLACE},
+		{CEA,27,54000,2880,2928,3180,3456,288,290,293,312,0},
+		{CEA,28,54000,2880,2928,3180,3456,288,290,293,312,0},
+		{CEA,29,54000,1440,1464,1592,1728,576,581,586,625,0},
+		{CEA,30,54000,1440,1464,1592,1728,576,581,586,625,0},
+		{CEA,31,148500,1920,2448,2492,2640,1080,1084,1089,1125,PHSYNC|PVSYNC},
+		{CEA,32,74250,1920,2558,2602,2750,1080,1084,1089,1125,PHSYNC|PVSYNC},
+		{CEA,33,74250,1920,2448,2492,2640,1080,1084,1089,1125,PHSYNC|PVSYNC},
+		{CEA,34,74250,1920,2008,2052,2200,1080,1084,1089,1125,PHSYNC|PVSYNC},
+		{CEA,35,108000,2880,2944,3192,3432,480,489,495,525,0},
+		{CEA,36,108000,2880,2944,3192,3432,480,489,495,525,0},
+		{CEA,37,108000,2880,2928,3184,3456,576,581,586,625,0},
+		{CEA,38,108000,2880,2928,3184,3456,576,581,586,625,0},
+		{CEA,39,72000,1920,1952,2120,2304,1080,1126,1136,1250,PHSYNC|INTERLACE},
+		{CEA,40,148500,1920,2448,2492,2640,1080,1084,1094,1125,PHSYNC|PVSYNC|INTERLACE},
+		{CEA,41,148500,1280,1720,1760,1980,720,725,730,750,PHSYNC|PVSYNC},
+		{CEA,42,54000,720,732,796,864,576,581,586,625,0},
+		{CEA,43,54000,720,732,796,864,576,581,586,625,0},
+		{CEA,44,54000,1440,1464,1590,1728,576,580,586,625,INTERLACE},
+		{CEA,45,54000,1440,1464,1590,1728,576,580,586,625,INTERLACE},
+		{CEA,46,148500,1920,2008,2052,2200,1080,1084,1094,1125,PHSYNC|PVSYNC|INTERLACE},
+		{CEA,47,148500,1280,1390,1430,1650,720,725,730,750,PHSYNC|PVSYNC},
+		{CEA,48,54000,720,736,798,858,480,489,495,525,0},
+		{CEA,49,54000,720,736,798,858,480,489,495,525,0},
+		{CEA,50,54000,1440,1478,1602,1716,480,488,494,525,INTERLACE},
+		{CEA,51,54000,1440,1478,1602,1716,480,488,494,525,INTERLACE},
+		{CEA,52,108000,720,732,796,864,576,581,586,625,0},
+		{CEA,53,108000,720,732,796,864,576,581,586,625,0},
+		{CEA,54,108000,1440,1464,1590,1728,576,580,586,625,INTERLACE},
+		{CEA,55,108000,1440,1464,1590,1728,576,580,586,625,INTERLACE},
+		{CEA,56,108000,720,736,798,858,480,489,495,525,0},
+		{CEA,57,108000,720,736,798,858,480,489,495,525,0},
+		{CEA,58,108000,1440,1478,1602,1716,480,488,494,525,INTERLACE},
+		{CEA,59,108000,1440,1478,1602,1716,480,488,494,525,INTERLACE},
+		{CEA,60,59400,1280,3040,3080,3300,720,725,730,750,PHSYNC|PVSYNC},
+		{CEA,61,74250,1280,3700,3740,3960,720,725,730,750,PHSYNC|PVSYNC},
+		{CEA,62,74250,1280,3040,3080,3300,720,725,730,750,PHSYNC|PVSYNC},
+		{CEA,63,297000,1920,2008,2052,2200,1080,1084,1089,1125,PHSYNC|PVSYNC},
+		{CEA,64,297000,1920,2448,2492,2640,1080,1084,1089,1125,PHSYNC|PVSYNC},
+		{CEA,65,59400,1280,3040,3080,3300,720,725,730,750,PHSYNC|PVSYNC},
+		{CEA,66,74250,1280,3700,3740,3960,720,725,730,750,PHSYNC|PVSYNC},
+		{CEA,67,74250,1280,3040,3080,3300,720,725,730,750,PHSYNC|PVSYNC},
+		{CEA,68,74250,1280,1720,1760,1980,720,725,730,750,PHSYNC|PVSYNC},
+		{CEA,69,74250,1280,1390,1430,1650,720,725,730,750,PHSYNC|PVSYNC},
+		{CEA,70,148500,1280,1720,1760,1980,720,725,730,750,PHSYNC|PVSYNC},
+		{CEA,71,148500,1280,1390,1430,1650,720,725,730,750,PHSYNC|PVSYNC},
+		{CEA,72,74250,1920,2558,2602,2750,1080,1084,1089,1125,PHSYNC|PVSYNC},
+		{CEA,73,74250,1920,2448,2492,2640,1080,1084,1089,1125,PHSYNC|PVSYNC},
+		{CEA,74,74250,1920,2008,2052,2200,1080,1084,1089,1125,PHSYNC|PVSYNC},
+		{CEA,75,148500,1920,2448,2492,2640,1080,1084,1089,1125,PHSYNC|PVSYNC},
+		{CEA,76,148500,1920,2008,2052,2200,1080,1084,1089,1125,PHSYNC|PVSYNC},
+		{CEA,77,297000,1920,2448,2492,2640,1080,1084,1089,1125,PHSYNC|PVSYNC},
+		{CEA,78,297000,1920,2008,2052,2200,1080,1084,1089,1125,PHSYNC|PVSYNC},
+		{CEA,79,59400,1680,3040,3080,3300,720,725,730,750,PHSYNC|PVSYNC},
+		{CEA,80,59400,1680,2908,2948,3168,720,725,730,750,PHSYNC|PVSYNC},
+		{CEA,81,59400,1680,2380,2420,2640,720,725,730,750,PHSYNC|PVSYNC},
+		{CEA,82,82500,1680,1940,1980,2200,720,725,730,750,PHSYNC|PVSYNC},
+		{CEA,83,99000,1680,1940,1980,2200,720,725,730,750,PHSYNC|PVSYNC},
+		{CEA,84,165000,1680,1740,1780,2000,720,725,730,825,PHSYNC|PVSYNC},
+		{CEA,85,198000,1680,1740,1780,2000,720,725,730,825,PHSYNC|PVSYNC},
+		{CEA,86,99000,2560,3558,3602,3750,1080,1084,1089,1100,PHSYNC|PVSYNC},
+		{CEA,87,90000,2560,3008,3052,3200,1080,1084,1089,1125,PHSYNC|PVSYNC},
+		{CEA,88,118800,2560,3328,3372,3520,1080,1084,1089,1125,PHSYNC|PVSYNC},
+		{CEA,89,185625,2560,3108,3152,3300,1080,1084,1089,1125,PHSYNC|PVSYNC},
+		{CEA,90,198000,2560,2808,2852,3000,1080,1084,1089,1100,PHSYNC|PVSYNC},
+		{CEA,91,371250,2560,2778,2822,2970,1080,1084,1089,1250,PHSYNC|PVSYNC},
+		{CEA,92,495000,2560,3108,3152,3300,1080,1084,1089,1250,PHSYNC|PVSYNC},
+		{CEA,93,297000,3840,5116,5204,5500,2160,2168,2178,2250,PHSYNC|PVSYNC},
+		{CEA,94,297000,3840,4896,4984,5280,2160,2168,2178,2250,PHSYNC|PVSYNC},
+		{CEA,95,297000,3840,4016,4104,4400,2160,2168,2178,2250,PHSYNC|PVSYNC},
+		{CEA,96,594000,3840,4896,4984,5280,2160,2168,2178,2250,PHSYNC|PVSYNC},
+		{CEA,97,594000,3840,4016,4104,4400,2160,2168,2178,2250,PHSYNC|PVSYNC},
+		{CEA,98,297000,4096,5116,5204,5500,2160,2168,2178,2250,PHSYNC|PVSYNC},
+		{CEA,99,297000,4096,5064,5152,5280,2160,2168,2178,2250,PHSYNC|PVSYNC},
+		{CEA,100,297000,4096,4184,4272,4400,2160,2168,2178,2250,PHSYNC|PVSYNC},
+		{CEA,101,594000,4096,5064,5152,5280,2160,2168,2178,2250,PHSYNC|PVSYNC},
+		{CEA,102,594000,4096,4184,4272,4400,2160,2168,2178,2250,PHSYNC|PVSYNC},
+		{CEA,103,297000,3840,5116,5204,5500,2160,2168,2178,2250,PHSYNC|PVSYNC},
+		{CEA,104,297000,3840,4896,4984,5280,2160,2168,2178,2250,PHSYNC|PVSYNC},
+		{CEA,105,297000,3840,4016,4104,4400,2160,2168,2178,2250,PHSYNC|PVSYNC},
+		{CEA,106,594000,3840,4896,4984,5280,2160,2168,2178,2250,PHSYNC|PVSYNC},
+		{CEA,107,594000,3840,4016,4104,4400,2160,2168,2178,2250,PHSYNC|PVSYNC}
+	};
+
+	inline constexpr unsigned standardModeCount = sizeof(standardModes)/sizeof(standardModes[0]);
+	inline constexpr unsigned ceaFirst = 88;
+	inline constexpr unsigned ceaLast = 107;
+
+	/* Closest standard mode of the given size and scan within half a hertz
+	 * of the requested rate, DMT before CEA on a tie. NULL when none. */
+	constexpr const StandardMode * findStandardMode(unsigned width,unsigned height,double refresh,bool interlaced=false){
+		const StandardMode * best = NULL;
+		double bestDistance = 0.5;
+		for(unsigned i=0;i<standardModeCount;i++){
+			const StandardMode &m = standardModes[i];
+			if(m.hActive!=width || m.vActive!=height || ((m.flags&INTERLACE)!=0)!=interlaced)
+				continue;
+			double d = m.refresh()-refresh;
+			d = d<0 ? -d : d;
+			if(d<bestDistance){
+				best = &m;
+				bestDistance = d;
+			}
+		}
+		return best;
+	}
+
+	/* Table entry of a CEA-861 VIC, NULL outside 1 to 107 */
+	constexpr const StandardMode * ceaMode(unsigned vic){
+		return vic>=1 && vic<=ceaLast ? &standardModes[ceaFirst+vic-1] : NULL;
+	}
+
+	Timing standardTiming(const StandardMode &mode);
+
+	class Edid;
+
+	/* The monitor's own detailed timing for the mode when its EDID has one,
+	 * then a standard DMT or CEA timing, CVT for anything else. Named by
+	 * size and rate so modes of one size at different rates stay apart. */
+	Timing modeTiming(const Edid &edid,unsigned width,unsigned height,double rate,bool interlaced=false);
+}
+
+#endif
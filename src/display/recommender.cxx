@@ -0,0 +1,238 @@
+#include "recommender.h"
+#include "sysfs.h"
+#include "../util/mappedfile.h"
+
+#include<iostream>
+#include<algorithm>
+#include<stdlib.h>
+#include<string.h>
+#include<time.h>
+#include<dirent.h>
+#include<fnmatch.h>
+#include<sys/utsname.h>
+
+#define LOG_TAG "[SaX3-Display]"
+#define ANY_VENDOR 0xffffffffu
+
+using namespace std;
+
+namespace Display{
+
+	static double now(){
+		struct timespec ts;
+		clock_gettime(CLOCK_MONOTONIC,&ts);
+		return ts.tv_sec*1000.0 + ts.tv_nsec/1000000.0;
+	}
+
+	/* Kernel module, the Xorg driver made for it and whether it is a KMS
+	 * driver modesetting can run on */
+	static const struct{
+		const char * module,* xorg;
+		bool kms;
+	} kernelDrivers[] = {
+		{"i915","intel",true},{"xe",NULL,true},{"amdgpu","amdgpu",true},{"radeon","radeon",true},
+		{"nouveau","nouveau",true},{"nvidia","nvidia",false},{"vmwgfx","vmware",true},{"qxl","qxl",true},
+		{"virtio_gpu",NULL,true},{"bochs",NULL,true},{"bochs_drm",NULL,true},{"cirrus",NULL,true},
+		{"ast",NULL,true},{"mgag200",NULL,true},{"hibmc_drm",NULL,true}
+	};
+
+	static const char * ranked[] = {"modesetting","amdgpu","intel","nvidia","radeon","nouveau","vmware","qxl","fbdev","vesa",NULL};
+
+	static string moduleName(string name){
+		replace(name.begin(),name.end(),'-','_');
+		return name;
+	}
+
+	/* The 8 hex digits after pci:v, ANY_VENDOR when they hold a wildcard */
+	static unsigned hexVendor(const char * p){
+		unsigned v = 0;
+		for(int i=0;i<8;i++){
+			char ch = p[i];
+			if(ch>='0' && ch<='9')
+				v = v<<4 | (ch-'0');
+			else if(ch>='A' && ch<='F')
+				v = v<<4 | (ch-'A'+10);
+			else if(ch>='a' && ch<='f')
+				v = v<<4 | (ch-'a'+10);
+			else
+				return ANY_VENDOR;
+		}
+		return v;
+	}
+
+	Recommender::Recommender(const char * sysfsRoot,const char * aliasFile,const char * driverDir){
+		root = Display::sysfsRoot(sysfsRoot);
+		if(aliasFile!=NULL){
+			aliasPath = aliasFile;
+		}else{
+			struct utsname u;
+			if(uname(&u)==0)
+				aliasPath = string("/lib/modules/")+u.release+"/modules.alias";
+		}
+		if(driverDir!=NULL){
+			driverDirs.push_back(driverDir);
+		}else{
+			driverDirs.push_back("/usr/lib64/xorg/modules/drivers");
+			driverDirs.push_back("/usr/lib/xorg/modules/drivers");
+		}
+		scanTime = 0;
+	}
+
+	/* pci lines of the given vendors and of any vendor, sorted by the
+	 * vendor their pattern fixes, wildcard vendors at the end */
+	void Recommender::loadAliases(const vector<unsigned> &vendors){
+		aliases.clear();
+		Util::MappedFile file(aliasPath);
+		if(!file.isOpen()){
+			cerr<<LOG_TAG<<" Cannot open "<<aliasPath<<endl;
+			return;
+		}
+		const char * p = file.data(),* end = p+file.size();
+		while(p<end){
+			const char * eol = (const char*)memchr(p,'\n',end-p);
+			if(eol==NULL)
+				eol = end;
+			if(eol-p>16 && memcmp(p,"alias pci:v",11)==0){
+				const char * pattern = p+6;
+				const char * space = (const char*)memchr(pattern,' ',eol-pattern);
+				unsigned vendor = space!=NULL && space-pattern>13 ? hexVendor(pattern+5) : ANY_VENDOR;
+				if(space!=NULL && (vendor==ANY_VENDOR || binary_search(vendors.begin(),vendors.end(),vendor))){
+					Alias a;
+					a.vendor = vendor;
+					a.pattern.assign(pattern,space-pattern);
+					a.module = moduleName(string(space+1,eol-space-1));
+					aliases.push_back(a);
+				}
+			}
+			p = eol+1;
+		}
+		stable_sort(aliases.begin(),aliases.end(),[](const Alias &a,const Alias &b){
+			return a.vendor<b.vendor;
+		});
+	}
+
+	void Recommender::loadInstalled(){
+		installed.clear();
+		for(unsigned i=0;i<driverDirs.size();i++){
+			DIR * dp = opendir(driverDirs[i].c_str());
+			if(dp==NULL)
+				continue;
+			struct dirent * ep;
+			while((ep = readdir(dp))!=NULL){
+				size_t n = strlen(ep->d_name);
+				if(n>7 && strcmp(ep->d_name+n-7,"_drv.so")==0)
+					installed.push_back(string(ep->d_name,n-7));
+			}
+			closedir(dp);
+		}
+		sort(installed.begin(),installed.end());
+		installed.erase(unique(installed.begin(),installed.end()),installed.end());
+	}
+
+	void Recommender::match(Controller &c) const{
+		if(!c.driver.empty())
+			c.modules.push_back(moduleName(c.driver));
+		vector<string> found;
+		unsigned vendors[2] = {c.vendor,ANY_VENDOR};
+		for(int v=0;v<2;v++){
+			Alias key;
+			key.vendor = vendors[v];
+			auto range = equal_range(aliases.begin(),aliases.end(),key,[](const Alias &a,const Alias &b){
+				return a.vendor<b.vendor;
+			});
+			for(auto i=range.first;i!=range.second;++i){
+				if(fnmatch(i->pattern.c_str(),c.modalias.c_str(),0)==0)
+					found.push_back(i->module);
+			}
+		}
+		sort(found.begin(),found.end());
+		for(unsigned i=0;i<found.size();i++){
+			if(find(c.modules.begin(),c.modules.end(),found[i])==c.modules.end())
+				c.modules.push_back(found[i]);
+		}
+	}
+
+	bool Recommender::scan(){
+		double start = now();
+		controllerList.clear();
+		ranking.clear();
+		string dir = root+"/bus/pci/devices";
+		DIR * dp = opendir(dir.c_str());
+		if(dp==NULL){
+			cerr<<LOG_TAG<<" Cannot open "<<dir<<endl;
+			return false;
+		}
+		vector<string> slots;
+		struct dirent * ep;
+		while((ep = readdir(dp))!=NULL){
+			if(ep->d_name[0]!='.')
+				slots.push_back(ep->d_name);
+		}
+		closedir(dp);
+		sort(slots.begin(),slots.end());
+
+		for(unsigned i=0;i<slots.size();i++){
+			string device = dir+"/"+slots[i];
+			unsigned classCode = strtoul(readLine(device+"/class").c_str(),NULL,16);
+			if(classCode>>16!=0x03)
+				continue;
+			Controller c;
+			c.slot = slots[i];
+			c.classCode = classCode;
+			c.vendor = strtoul(readLine(device+"/vendor").c_str(),NULL,16);
+			c.device = strtoul(readLine(device+"/device").c_str(),NULL,16);
+			c.modalias = readLine(device+"/modalias");
+			c.driver = linkName(device+"/driver");
+			controllerList.push_back(c);
+		}
+		vector<unsigned> vendors;
+		for(unsigned i=0;i<controllerList.size();i++)
+			vendors.push_back(controllerList[i].vendor);
+		sort(vendors.begin(),vendors.end());
+		if(!vendors.empty())
+			loadAliases(vendors);
+		loadInstalled();
+
+		vector<string> candidates;
+		candidates.push_back("fbdev");
+		candidates.push_back("vesa");
+		for(unsigned i=0;i<controllerList.size();i++){
+			Controller &c = controllerList[i];
+			match(c);
+			for(unsigned j=0;j<c.modules.size();j++){
+				for(unsigned k=0;k<sizeof(kernelDrivers)/sizeof(kernelDrivers[0]);k++){
+					if(c.modules[j]!=kernelDrivers[k].module)
+						continue;
+					if(kernelDrivers[k].xorg!=NULL)
+						candidates.push_back(kernelDrivers[k].xorg);
+					if(kernelDrivers[k].kms)
+						candidates.push_back("modesetting");
+				}
+			}
+		}
+		for(int i=0;ranked[i]!=NULL;i++){
+			if(find(candidates.begin(),candidates.end(),ranked[i])==candidates.end())
+				continue;
+			if(installed.empty() || binary_search(installed.begin(),installed.end(),ranked[i]))
+				ranking.push_back(ranked[i]);
+		}
+		scanTime = now()-start;
+		cout<<LOG_TAG<<" Recommending";
+		for(unsigned i=0;i<ranking.size();i++)
+			cout<<' '<<ranking[i];
+		cout<<" for "<<controllerList.size()<<" display controllers in "<<scanTime<<" ms"<<endl;
+		return true;
+	}
+
+	const vector<Controller> & Recommender::controllers() const{
+		return controllerList;
+	}
+
+	const vector<string> & Recommender::drivers() const{
+		return ranking;
+	}
+
+	double Recommender::scanMillis() const{
+		return scanTime;
+	}
+}
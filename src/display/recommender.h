@@ -0,0 +1,53 @@
+#ifndef RECOMMENDER_H_
+#define RECOMMENDER_H_
+
+#include<string>
+#include<vector>
+
+namespace Display{
+
+	/* PCI display controller, modules are the kernel modules that can bind
+	 * it, the bound one first */
+	struct Controller{
+		std::string slot,driver,modalias;
+		unsigned vendor,device,classCode;
+		std::vector<std::string> modules;
+	};
+
+/*! \class Recommender
+    \brief Ranked Xorg drivers for the display controllers of the machine
+
+    Reads class, vendor, device, modalias and the bound driver of every
+    display controller below bus/pci/devices and matches the modalias
+    against the pci patterns of modules.alias. The file is mapped and only
+    the patterns of vendors present and those matching any vendor are kept,
+    indexed by vendor, so each device is compared with a few dozen patterns
+    instead of the whole file. Kernel modules map to
+    Xorg drivers, which are kept if their _drv.so is installed, and come out
+    as modesetting, amdgpu, intel, nvidia, other vendor drivers, fbdev,
+    vesa. The result only depends on the files read.
+    */
+	class Recommender{
+		struct Alias{
+			unsigned vendor;
+			std::string pattern,module;
+		};
+		std::string root,aliasPath;
+		std::vector<std::string> driverDirs;
+		std::vector<Alias> aliases;
+		std::vector<Controller> controllerList;
+		std::vector<std::string> installed,ranking;
+		double scanTime;
+		void loadAliases(const std::vector<unsigned> &vendors);
+		void loadInstalled();
+		void match(Controller &c) const;
+		public:
+		Recommender(const char * sysfsRoot=NULL,const char * aliasFile=NULL,const char * driverDir=NULL);
+		bool scan();
+		const std::vector<Controller> & controllers() const;
+		const std::vector<std::string> & drivers() const;
+		double scanMillis() const;
+	};
+}
+
+#endif
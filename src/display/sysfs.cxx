@@ -0,0 +1,63 @@
+#include "sysfs.h"
+
+#include<stdlib.h>
+#include<string.h>
+#include<fcntl.h>
+#include<unistd.h>
+
+using namespace std;
+
+#define SYSFS_ROOT "/sys"
+
+namespace Display{
+
+	string sysfsRoot(const char * root){
+		const char * env = getenv("SAX3_SYSFS_ROOT");
+		return root!=NULL ? root : (env!=NULL && *env ? env : SYSFS_ROOT);
+	}
+
+	/* sysfs reports a page as size for every attribute, so read until EOF
+	 * instead of trusting stat. */
+	bool readFile(const string &path,string &out){
+		out.clear();
+		int fd = open(path.c_str(),O_RDONLY|O_CLOEXEC);
+		if(fd==-1)
+			return false;
+		char buffer[4096];
+		ssize_t n;
+		while((n = read(fd,buffer,sizeof(buffer)))>0)
+			out.append(buffer,n);
+		close(fd);
+		return n==0;
+	}
+
+	string readLine(const string &path){
+		string s;
+		readFile(path,s);
+		size_t end = s.find_last_not_of(" \t\n");
+		return end==string::npos ? "" : s.substr(0,end+1);
+	}
+
+	string devRoot(const string &sysfsRoot){
+		return sysfsRoot==SYSFS_ROOT ? "/dev" : sysfsRoot+"/dev";
+	}
+
+	bool readBytes(const string &path,off_t offset,void * buffer,size_t size){
+		int fd = open(path.c_str(),O_RDONLY|O_CLOEXEC);
+		if(fd==-1)
+			return false;
+		ssize_t n = pread(fd,buffer,size,offset);
+		close(fd);
+		return n==(ssize_t)size;
+	}
+
+	string linkName(const string &path){
+		char buffer[1024];
+		ssize_t n = readlink(path.c_str(),buffer,sizeof(buffer)-1);
+		if(n<=0)
+			return "";
+		buffer[n] = 0;
+		const char * slash = strrchr(buffer,'/');
+		return slash==NULL ? buffer : slash+1;
+	}
+}
@@ -0,0 +1,23 @@
+#ifndef SYSFS_H_
+#define SYSFS_H_
+
+#include<string>
+#include<sys/types.h>
+
+namespace Display{
+
+	/* The given root, else SAX3_SYSFS_ROOT when set, else /sys */
+	std::string sysfsRoot(const char * root);
+	/* Whole attribute, false when it cannot be read to the end */
+	bool readFile(const std::string &path,std::string &out);
+	/* Attribute without trailing blanks and newlines, empty when missing */
+	std::string readLine(const std::string &path);
+	/* /dev beside the real /sys, a dev directory inside any other root */
+	std::string devRoot(const std::string &sysfsRoot);
+	/* size bytes at offset of a device file, false on a short read */
+	bool readBytes(const std::string &path,off_t offset,void * buffer,size_t size);
+	/* Last component of a symlink target, such as the driver a device is bound to */
+	std::string linkName(const std::string &path);
+}
+
+#endif
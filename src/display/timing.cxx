@@ -0,0 +1,37 @@
+#include "timing.h"
+
+#include<stdio.h>
+
+using namespace std;
+
+namespace Display{
+
+	double Timing::refresh() const{
+		if(hTotal==0 || vTotal==0)
+			return 0;
+		double r = clock*1000.0/((double)hTotal*vTotal);
+		return interlaced ? r*2 : r;
+	}
+
+	double Timing::hSync() const{
+		return hTotal==0 ? 0 : (double)clock/hTotal;
+	}
+
+	/* Size and the rate the timing really gives, the way the X server
+	 * names its own modes: 640x480_59.94, 1920x1080i_50.00 */
+	string Timing::rateName() const{
+		char name[32];
+		snprintf(name,sizeof(name),"%ux%u%s_%.2f",hActive,vActive,interlaced ? "i" : "",refresh());
+		return name;
+	}
+
+	/* The part of an xorg.conf Modeline after the keyword, spaced the way
+	 * cvt prints it */
+	string Timing::modeline() const{
+		char line[160];
+		snprintf(line,sizeof(line),"\"%s\"  %6.2f  %u %u %u %u  %u %u %u %u%s%s%s",name.c_str(),clock/1000.0,
+			hActive,hSyncStart,hSyncEnd,hTotal,vActive,vSyncStart,vSyncEnd,vTotal,
+			interlaced ? " interlace" : "",hSyncPositive ? " +hsync" : " -hsync",vSyncPositive ? " +vsync" : " -vsync");
+		return line;
+	}
+}
@@ -0,0 +1,23 @@
+#ifndef TIMING_H_
+#define TIMING_H_
+
+#include<string>
+
+namespace Display{
+
+	/* Detailed timing in modeline terms, pixel clock in kHz. Interlaced
+	 * timings carry frame lines, not field lines. */
+	struct Timing{
+		std::string name;
+		unsigned clock;
+		unsigned hActive,hSyncStart,hSyncEnd,hTotal;
+		unsigned vActive,vSyncStart,vSyncEnd,vTotal;
+		bool interlaced,hSyncPositive,vSyncPositive,preferred;
+		double refresh() const;
+		double hSync() const;
+		std::string rateName() const;
+		std::string modeline() const;
+	};
+}
+
+#endif
@@ -0,0 +1,65 @@
+#include "topology.h"
+
+using namespace std;
+
+namespace Display{
+
+	void Topology::clear(){
+		gpuList.clear();
+	}
+
+	/* edids runs parallel to connectors */
+	void Topology::build(const vector<Card> &cards,const vector<Connector> &connectors,const vector<Edid> &edids){
+		gpuList.clear();
+		gpuList.resize(cards.size());
+		for(unsigned i=0;i<cards.size();i++)
+			gpuList[i].card = cards[i];
+		for(unsigned i=0;i<connectors.size();i++){
+			Output o;
+			o.connector = connectors[i];
+			o.edid = edids[i];
+			o.decoded = edids[i].isValid();
+			gpuList[connectors[i].card].outputs.push_back(o);
+		}
+	}
+
+	const vector<Gpu> & Topology::gpus() const{
+		return gpuList;
+	}
+
+	unsigned Topology::connectedCount() const{
+		unsigned n = 0;
+		for(unsigned i=0;i<gpuList.size();i++){
+			for(unsigned j=0;j<gpuList[i].outputs.size();j++){
+				if(gpuList[i].outputs[j].connector.status==CONNECTED)
+					n++;
+			}
+		}
+		return n;
+	}
+
+	const Output * Topology::primary() const{
+		const Output * first = NULL;
+		for(unsigned i=0;i<gpuList.size();i++){
+			for(unsigned j=0;j<gpuList[i].outputs.size();j++){
+				const Output &o = gpuList[i].outputs[j];
+				if(o.connector.status!=CONNECTED)
+					continue;
+				if(gpuList[i].card.bootVga)
+					return &o;
+				if(first==NULL)
+					first = &o;
+			}
+		}
+		return first;
+	}
+
+	const Gpu * Topology::gpuOf(const Output * output) const{
+		for(unsigned i=0;i<gpuList.size();i++){
+			const vector<Output> &outputs = gpuList[i].outputs;
+			if(!outputs.empty() && output>=&outputs[0] && output<=&outputs.back())
+				return &gpuList[i];
+		}
+		return NULL;
+	}
+}
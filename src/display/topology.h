@@ -0,0 +1,61 @@
+#ifndef TOPOLOGY_H_
+#define TOPOLOGY_H_
+
+#include "edid.h"
+
+#include<string>
+#include<vector>
+
+namespace Display{
+
+	enum Status{CONNECTED,DISCONNECTED,UNKNOWN};
+
+	struct Card{
+		std::string name,driver,busId;
+		unsigned vendor,device;
+		bool bootVga;
+	};
+
+	struct Connector{
+		std::string name;
+		unsigned card;
+		Status status;
+		bool enabled;
+		int vrrCapable;
+		unsigned linkRate,lanes;
+		std::vector<std::string> modes;
+		std::string edid;
+	};
+
+	/* A connector together with its decoded EDID */
+	struct Output{
+		Connector connector;
+		Edid edid;
+		bool decoded;
+	};
+
+	struct Gpu{
+		Card card;
+		std::vector<Output> outputs;
+	};
+
+/*! \class Topology
+    \brief Every card with its connectors, as one probe found them
+
+    Cards keep the detector's order, each with its outputs by name.
+    primary() is the first connected output of the boot VGA card, or of
+    any card when that one has none.
+    */
+	class Topology{
+		std::vector<Gpu> gpuList;
+		public:
+		void clear();
+		void build(const std::vector<Card> &cards,const std::vector<Connector> &connectors,const std::vector<Edid> &edids);
+		const std::vector<Gpu> & gpus() const;
+		unsigned connectedCount() const;
+		const Output * primary() const;
+		const Gpu * gpuOf(const Output * output) const;
+	};
+}
+
+#endif
@@ -0,0 +1,116 @@
+#include "validator.h"
+#include "cvt.h"
+
+#include<string.h>
+
+using namespace std;
+
+#define SYNC_TOLERANCE 0.01
+
+namespace Display{
+
+	static const Ranges noLimits = {0,0,0,0,0};
+
+	Validator::Validator(){
+		monitor = user = noLimits;
+		link = 0;
+		userSet = false;
+	}
+
+	void Validator::setMonitor(const Edid &edid){
+		const RangeLimits &r = edid.range();
+		monitor = noLimits;
+		if(r.maxHRate){
+			monitor.minHSync = r.minHRate;
+			monitor.maxHSync = r.maxHRate;
+		}
+		if(r.maxVRate){
+			monitor.minVRefresh = r.minVRate;
+			monitor.maxVRefresh = r.maxVRate;
+		}
+		monitor.maxClock = r.maxClock;
+	}
+
+	void Validator::setUser(double minHSync,double maxHSync,double minVRefresh,double maxVRefresh){
+		user.minHSync = minHSync;
+		user.maxHSync = maxHSync;
+		user.minVRefresh = minVRefresh;
+		user.maxVRefresh = maxVRefresh;
+		user.maxClock = 0;
+		userSet = true;
+	}
+
+	void Validator::clearUser(){
+		user = noLimits;
+		userSet = false;
+	}
+
+	void Validator::setLink(const Connector &connector,const Edid &edid){
+		const string &name = connector.name;
+		link = 0;
+		if(strncmp(name.c_str(),"HDMI",4)==0){
+			link = edid.maxTmdsClock() ? edid.maxTmdsClock() : 165000;
+		}else if(strncmp(name.c_str(),"DVI",3)==0){
+			link = 330000;
+		}else if(strncmp(name.c_str(),"DP",2)==0 || strncmp(name.c_str(),"eDP",3)==0){
+			unsigned rate = connector.linkRate ? connector.linkRate : 5400;
+			unsigned lanes = connector.lanes ? connector.lanes : 4;
+			link = (unsigned)((unsigned long long)rate*lanes*8/10*1000/24);
+		}
+	}
+
+	unsigned Validator::linkClock() const{
+		return link;
+	}
+
+	static unsigned outside(const Ranges &r,const Timing &t){
+		unsigned problems = 0;
+		double h = t.hSync(),v = t.refresh();
+		if(r.maxClock && t.clock>r.maxClock)
+			problems |= PIXEL_CLOCK;
+		if(r.maxHSync && (h<r.minHSync*(1-SYNC_TOLERANCE) || h>r.maxHSync*(1+SYNC_TOLERANCE)))
+			problems |= HSYNC;
+		if(r.maxVRefresh && (v<r.minVRefresh*(1-SYNC_TOLERANCE) || v>r.maxVRefresh*(1+SYNC_TOLERANCE)))
+			problems |= VREFRESH;
+		return problems;
+	}
+
+	unsigned Validator::check(const Timing &t) const{
+		unsigned problems = outside(monitor,t);
+		if(userSet)
+			problems |= outside(user,t);
+		if(link && t.clock>link)
+			problems |= LINK;
+		return problems;
+	}
+
+	bool Validator::fit(Timing &t) const{
+		if(check(t)==0)
+			return true;
+		if(t.interlaced)
+			return false;
+		static const Blanking blankings[] = {REDUCED,REDUCED_V2};
+		for(unsigned i=0;i<2;i++){
+			Timing reduced = cvt(t.hActive,t.vActive,t.refresh(),blankings[i]);
+			if(reduced.hActive!=t.hActive || reduced.vActive!=t.vActive || check(reduced)!=0)
+				continue;
+			reduced.preferred = t.preferred;
+			t = reduced;
+			return true;
+		}
+		return false;
+	}
+
+	string Validator::describe(unsigned problems){
+		static const char * names[] = {"pixel clock","horizontal sync","vertical refresh","link bandwidth"};
+		string s;
+		for(unsigned i=0;i<4;i++){
+			if(!(problems & 1<<i))
+				continue;
+			if(!s.empty())
+				s += ", ";
+			s += names[i];
+		}
+		return s;
+	}
+}
@@ -0,0 +1,55 @@
+#ifndef VALIDATOR_H_
+#define VALIDATOR_H_
+
+#include "topology.h"
+#include "timing.h"
+
+#include<string>
+
+namespace Display{
+
+	/* What check() found wrong with a timing, or'ed together */
+	enum Problem{PIXEL_CLOCK=1,HSYNC=2,VREFRESH=4,LINK=8};
+
+	/* Sync ranges in kHz and Hz, clock in kHz, 0 for no limit */
+	struct Ranges{
+		double minHSync,maxHSync,minVRefresh,maxVRefresh;
+		unsigned maxClock;
+	};
+
+/*! \class Validator
+    \brief Checks a timing against what the monitor, the user and the link allow
+
+    The monitor's limits come from the EDID range descriptor, the user's
+    from the sync ranges entered in the dialog. Both are checked with the
+    1% tolerance the X server allows on sync rates. The link limit depends
+    on the connector type: the TMDS clock the HDMI blocks of the EDID
+    declare, 165 MHz for HDMI sinks that declare none, 330 MHz for dual
+    link DVI and the DisplayPort data rate, lanes times rate per lane less
+    8b/10b coding, spread over 24 bits per pixel. A DisplayPort receiver
+    that could not be asked counts as four lanes of HBR2. Analog outputs
+    only have the monitor's limits.
+
+    fit() keeps a timing that passes and otherwise tries CVT reduced
+    blanking, then reduced blanking v2, for the same size and rate. It
+    takes the first that passes in place of the original and fails when
+    none does, so nothing the monitor or link cannot take is written.
+    */
+	class Validator{
+		Ranges monitor,user;
+		unsigned link;
+		bool userSet;
+		public:
+		Validator();
+		void setMonitor(const Edid &edid);
+		void setUser(double minHSync,double maxHSync,double minVRefresh,double maxVRefresh);
+		void clearUser();
+		void setLink(const Connector &connector,const Edid &edid);
+		unsigned linkClock() const;
+		unsigned check(const Timing &t) const;
+		bool fit(Timing &t) const;
+		static std::string describe(unsigned problems);
+	};
+}
+
+#endif
@@ -6,12 +6,14 @@
 #include<sys/types.h>
 #include<string.h>
 #include<list>
-
-extern "C"{
-#include<augeas.h>
-}
+#include<thread>
 
 #include "ui/yuifactory.h"
+#include "config/configstore.h"
+#include "config/transaction.h"
+#include "xkb/catalogue.h"
+#include "xkb/search.h"
+#include "xkb/localeindex.h"
 
 #include<iostream>
 #include<fstream>
@@ -27,31 +29,43 @@ using namespace std;
 class simpleMode;
 class expertMode;
 
+/*! \brief Keyboard settings shared by the simple and the expert view
+
+    Layouts, variants, model and options are held as XKB codes, so the simple
+    view can show them without completing the catalogue. */
+struct keyboardModel{
+	string current;
+	string layout;
+	vector< pair<string,string> > layouts;
+	string model;
+	vector<string> options;
+	string query;
+};
+
 class keyboard{
 	protected:
-	map<string,string> layout;
-	map<string,string> model;
-	map<string,string> variant;
-	vector< pair<string,string> >options;
-	string s1,line,optionType;
-	ifstream baseFile;
+	keyboardModel settings;
+	XKB::Catalogue * catalogue;
+	XKB::Search * search;
+	XKB::LocaleIndex * locales;
+	std::thread localeLoader;
+	enum{HIDDEN,VIA_CHILD,DIRECT};
+	vector<char> hit[XKB::KINDS];
+	bool filtering,anyHit[XKB::KINDS];
 	
-	augeas * aug;
-	char * root,* loadpath;
-	unsigned int flag;
-
-	enum{MODEL,LAYOUT,VARIANT,OPTION};
-	int type;
+	Conf::ConfigStore * store;
 	
 	UI::YUIFactory * factory;
 	UI::yDialog * dialog;
-	UI::yVLayout * mainLayout;
+	UI::yVLayout * mainLayout,*viewLayout;
+	UI::yReplacePoint * view;
 	UI::yComboBox * layoutSelect;
 	UI::yHLayout * buttonLayout,*upperLayout,*addGroupLayout;
 	UI::yPushButton * activateMode,*saveButton,*cancelButton,*addLayoutVariant,*deleteLayoutVariant,*addGroup,*deleteGroup;
 	UI::yComboBox * modelSelect,*variantSelect,*groupCategory,*groupOptions;
 	UI::yLabel * labelSelect,*showDefaultLayout,*label1;
 	UI::yTable * layoutTable,*groupTable;
+	UI::yInputField * searchField;
 
 	UI::yVLayout * upDown1;
 	UI::yPushButton *upLayout,*downLayout;
@@ -61,6 +75,8 @@ class keyboard{
 
 	void drawSimpleMode();
 	void drawExpertMode();
+	void clearView();
+	void switchMode();
 
 	void split();
 	void fillUpLayoutSelect();
@@ -68,10 +84,15 @@ class keyboard{
 	void fillUpModelSelect();
 	void fillUpGroupCategory();
 	void fillUpGroupOptions();
-	bool writeConf(string &line,bool newNode,string parameter,bool isLastParameter,string extraParam,string value);
+	void applySearch();
+	void preselectLayouts();
+	bool visible(XKB::Kind,unsigned);
 	void loadSimpleConf();
 	void loadExpertConf();
-	vector<string> match(string,string);
+	void keepSimpleConf();
+	void keepExpertConf();
+	int keyboardSection();
+	string codeOf(XKB::Kind,const string &);
 	vector<string> parseOption(const char*);
 	int colNo;string xcolNo;
 	public:
@@ -85,49 +106,40 @@ class keyboard{
 };
 
 keyboard::keyboard(){
-	type=0;
-	baseFile.open("/usr/share/X11/xkb/rules/base.lst",ios::in);
-	if(baseFile.is_open()){
-			while(baseFile.good()){
-				getline(baseFile,line);
-				line.erase(0,2);
-				if(!line.compare("model")){type = MODEL;continue;}
-				if(!line.compare("layout")){type = LAYOUT;continue;}
-				if(!line.compare("variant")){type = VARIANT;continue;}
-				if(!line.compare("option")){type = OPTION;continue;}
-
-				int pos = line.find_first_of(' ');
-				s1 = line.substr(0,pos);line.erase(0,pos);
-				pos=line.find_first_of("abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ");
-				line.erase(0,pos-1);				
-				cout<<s1<<'\t'<<line<<endl;
-				if(type==MODEL && line.length()!=0){
-					model[line]=s1;
-				}
-				if(type==LAYOUT && line.length()!=0){
-					layout[line]=s1;
-				}
-				if(type==VARIANT && line.length()!=0){
-					variant[line]=s1;
-				}
-				if(type==OPTION && line.length()!=0){
-					options.push_back(make_pair(line,s1));
-				}
-
-			};
-	}
+	/* The locale index is only needed once simple mode is drawn, build it
+	 * while the catalogue and the configuration load */
+	locales = new XKB::LocaleIndex();
+	localeLoader = std::thread([this](){
+		locales->load();
+	});
+	catalogue = new XKB::Catalogue();
+	search = NULL;
+	deleteGroup = addGroup = addLayoutVariant = deleteLayoutVariant = upLayout = downLayout = NULL;
+	groupTable = layoutTable = NULL;
+	groupLayout = addGroupLayout = layoutLayout = upperLayout = NULL;
+	groupOptions = groupCategory = modelSelect = variantSelect = layoutSelect = NULL;
+	label1 = showDefaultLayout = NULL;
+	upDown1 = viewLayout = NULL;
+	searchField = NULL;
+	filtering = false;
 	SIMPLEMODE = true;
 	factory = new UI::YUIFactory();
-	aug=NULL;root=NULL;flag=0;loadpath=NULL;
-	aug = aug_init(root,loadpath,flag);
+	store = new Conf::ConfigStore();
 	colNo=0;
-	if(aug==NULL){
+	if(!store->isLoaded()){
 		cout<<"Cannot be opened";
 	}
 
 }
 
 void keyboard::drawLayout(){
+	dialog = factory->createDialog(60,10);
+	mainLayout = factory->createVLayout(dialog);
+	view = factory->createReplacePoint(mainLayout);
+	buttonLayout = factory->createHLayout(mainLayout);
+	activateMode = factory->createPushButton(buttonLayout,SIMPLEMODE ? _("E&xpert Mode") : _("&Simple Mode"));
+	saveButton = factory->createPushButton(buttonLayout,_("&Ok"));
+	cancelButton = factory->createPushButton(buttonLayout,_("&Cancel"));
 	if(SIMPLEMODE){
 		drawSimpleMode();
 	}else{
@@ -135,67 +147,83 @@ void keyboard::drawLayout(){
 	}
 }
 
+/* Read the keyboard section once. Both views are filled from and kept in
+ * settings afterwards, switching between them never asks the store again. */
 void keyboard::loadConf(){
-	if(SIMPLEMODE){
-		loadSimpleConf();
-	}else{
-		loadExpertConf();
+	int section = keyboardSection();
+	const Conf::SectionIndex &index = store->index();
+	const Conf::OptionRef * e;
+	if(section<0){
+		cerr<<"No Keyboard file exists, will load the default one"<<endl;
+		return;
 	}
+	vector<string> l = parseOption(index.option("XkbLayout",section)->value.c_str());
+	vector<string> v,o;
+	if((e = index.option("XkbVariant",section))!=NULL)
+		v = parseOption(e->value.c_str());
+	if((e = index.option("XkbOptions",section))!=NULL)
+		o = parseOption(e->value.c_str());
+	if((e = index.option("XkbModel",section))!=NULL)
+		settings.model = e->value;
+	for(unsigned i=0;i<l.size();i++){
+		if(l[i]!="")
+			settings.layouts.push_back(make_pair(l[i],i<v.size() ? v[i] : string()));
+	}
+	for(unsigned i=0;i<o.size();i++){
+		if(o[i]!="")
+			settings.options.push_back(o[i]);
+	}
+	if(!settings.layouts.empty())
+		settings.current = settings.layout = settings.layouts[0].first;
 }
 
 void keyboard::drawSimpleMode(){
-	factory = new UI::YUIFactory();
-	dialog = factory->createDialog(60,10);
-	mainLayout = factory->createVLayout(dialog);
-	layoutSelect = factory->createComboBox(mainLayout,_("Select your keyboard Layout"));
-	showDefaultLayout = factory->createLabel(mainLayout,"No configuration exists");
-	buttonLayout = factory->createHLayout(mainLayout);
-	activateMode = factory->createPushButton(buttonLayout,_("E&xpert Mode"));
-	saveButton = factory->createPushButton(buttonLayout,_("&Ok"));
-	cancelButton = factory->createPushButton(buttonLayout,_("&Cancel"));
+	viewLayout = factory->createVLayout(view);
+	layoutSelect = factory->createComboBox(viewLayout,_("Select your keyboard Layout"));
+	showDefaultLayout = factory->createLabel(viewLayout,"No configuration exists");
 	fillUpLayoutSelect();
+	preselectLayouts();
 	loadSimpleConf();
+	catalogue->prefetch();
 }
 
 void keyboard::drawExpertMode(){
-	dialog = factory->createDialog(120,40);
-	mainLayout = factory->createVLayout(dialog);
-	upperLayout = factory->createHLayout(mainLayout);
+	viewLayout = factory->createVLayout(view);
+	catalogue->complete();
+	if(search==NULL)
+		search = new XKB::Search(catalogue);
+	filtering = false;
+	searchField = factory->createInputField(viewLayout,_("Search layouts, variants and options"));
+	upperLayout = factory->createHLayout(viewLayout);
 	layoutSelect = factory->createComboBox(upperLayout,_("Select your keyboard Layout"));
 	fillUpLayoutSelect();
 	variantSelect = factory->createComboBox(upperLayout,_("Select Layout Variant"));
 	fillUpVariant();
 	addLayoutVariant = factory->createPushButton(upperLayout,_("Add"));
-	layoutLayout = factory->createHLayout(mainLayout);
+	layoutLayout = factory->createHLayout(viewLayout);
 	layoutTable = factory->createTable(layoutLayout,"Order","Layout","Variant");
 	upDown1 = factory->createVLayout(layoutLayout);
 	upLayout = factory->createPushButton(upDown1,_("&Up"));
 	downLayout = factory->createPushButton(upDown1,_("&Down"));
-	deleteLayoutVariant = factory->createPushButton(mainLayout,_("Delete selected Layout & Variant"));
-	modelSelect = factory->createComboBox(mainLayout,_("Select your Model"));
+	deleteLayoutVariant = factory->createPushButton(viewLayout,_("Delete selected Layout & Variant"));
+	modelSelect = factory->createComboBox(viewLayout,_("Select your Model"));
 	fillUpModelSelect();
-	label1 = factory->createLabel(mainLayout,"Advanced Options");
-	addGroupLayout = factory->createHLayout(mainLayout);
+	label1 = factory->createLabel(viewLayout,"Advanced Options");
+	addGroupLayout = factory->createHLayout(viewLayout);
 	groupCategory = factory->createComboBox(addGroupLayout,_("Category"));
 	fillUpGroupCategory();
 	groupOptions = factory->createComboBox(addGroupLayout,_("Relevant Options"));
 	fillUpGroupOptions();
 	addGroup = factory->createPushButton(addGroupLayout,_("Add"));
-	groupLayout = factory->createHLayout(mainLayout);
+	groupLayout = factory->createHLayout(viewLayout);
 	groupTable = factory->createTable(groupLayout,"Group","Option","");
-	deleteGroup = factory->createPushButton(mainLayout,_("Delete Selected Group"));
-	buttonLayout = factory->createHLayout(mainLayout);
-	activateMode = factory->createPushButton(buttonLayout,_("&Simple Mode"));
-	saveButton = factory->createPushButton(buttonLayout,_("&Ok"));
-	cancelButton = factory->createPushButton(buttonLayout,_("&Cancel"));
+	deleteGroup = factory->createPushButton(viewLayout,_("Delete Selected Group"));
 	loadExpertConf();
 }
 
-keyboard::~keyboard(){
-	delete cancelButton;
-	delete saveButton;
-	delete activateMode;
-	delete buttonLayout;
+/* Drop the widgets of the current view out of the replace point, the dialog
+ * and its buttons stay. */
+void keyboard::clearView(){
 	delete deleteGroup;
 	delete groupTable;
 	delete groupLayout;
@@ -215,16 +243,58 @@ keyboard::~keyboard(){
 	delete variantSelect;
 	delete layoutSelect;
 	delete upperLayout;
+	delete searchField;
+	delete showDefaultLayout;
+	delete viewLayout;
+	deleteGroup = addGroup = addLayoutVariant = deleteLayoutVariant = upLayout = downLayout = NULL;
+	groupTable = layoutTable = NULL;
+	groupLayout = addGroupLayout = layoutLayout = upperLayout = NULL;
+	groupOptions = groupCategory = modelSelect = variantSelect = layoutSelect = NULL;
+	label1 = showDefaultLayout = NULL;
+	upDown1 = viewLayout = NULL;
+	searchField = NULL;
+}
+
+void keyboard::switchMode(){
+	if(SIMPLEMODE){
+		keepSimpleConf();
+	}else{
+		keepExpertConf();
+	}
+	clearView();
+	SIMPLEMODE = !SIMPLEMODE;
+	if(SIMPLEMODE){
+		drawSimpleMode();
+	}else{
+		drawExpertMode();
+	}
+	activateMode->setLabel(SIMPLEMODE ? _("E&xpert Mode") : _("&Simple Mode"));
+	view->showChild();
+	dialog->redraw();
+}
+
+keyboard::~keyboard(){
+	clearView();
+	delete cancelButton;
+	delete saveButton;
+	delete activateMode;
+	delete buttonLayout;
+	delete view;
 	delete mainLayout;
 	delete dialog;
+	delete store;
+	delete search;
+	if(localeLoader.joinable())
+		localeLoader.join();
+	delete locales;
+	delete catalogue;
 }
 
 bool keyboard::respondToEvent(){
 	while(1){
 		dialog->wait();
-		if(activateMode->getElement()==dialog->eventWidget()){delete dialog;
-			SIMPLEMODE ? SIMPLEMODE = false : SIMPLEMODE = true;
-			!SIMPLEMODE ? drawExpertMode() : drawSimpleMode(); 
+		if(activateMode->getElement()==dialog->eventWidget()){
+			switchMode();
 			return true;
 		}
 		if(saveButton->getElement()==dialog->eventWidget()){
@@ -234,8 +304,8 @@ bool keyboard::respondToEvent(){
 				}else{
 					cerr<<"Successfully NOT written";
 				}
-			}else{
-				expertWriteConf();
+			}else if(!expertWriteConf()){
+				continue;
 			}
 			return false;
 		}	
@@ -243,6 +313,9 @@ bool keyboard::respondToEvent(){
 			return false;
 		}
 		if(!SIMPLEMODE){
+			if(searchField->getElement()==dialog->eventWidget()){
+				applySearch();
+			}
 			if(layoutSelect->getElement()==dialog->eventWidget()){
 				fillUpVariant();
 			}
@@ -277,236 +350,227 @@ bool keyboard::respondToEvent(){
 }
 
 void keyboard::fillUpLayoutSelect(){
-	layoutSelect->deleteAllItems();
-	map<string,string>::iterator it;
-	for(it=layout.begin();it!=layout.end();it++){
-	        layoutSelect->addItem(it->first);
+	vector<const char *> items;
+	for(unsigned i=0;i<catalogue->count(XKB::LAYOUT);i++){
+		if(visible(XKB::LAYOUT,i))
+		        items.push_back(catalogue->description(XKB::LAYOUT,i));
 	}
+	layoutSelect->setItems(items);
 }
 void keyboard::fillUpModelSelect(){
-	modelSelect->deleteAllItems();
-	map<string,string>::iterator it;
-	modelSelect->addItem("Default");
-	for(it=model.begin();it!=model.end();it++){
-		modelSelect->addItem(it->first);
+	vector<const char *> items;
+	items.push_back("Default");
+	for(unsigned i=0;i<catalogue->count(XKB::MODEL);i++){
+		if(visible(XKB::MODEL,i))
+			items.push_back(catalogue->description(XKB::MODEL,i));
 	}
+	modelSelect->setItems(items);
 }
 void keyboard::fillUpVariant(){
-	variantSelect->deleteAllItems();
-	map<string,string>::iterator it;int temp;
-	variantSelect->addItem("Default");
-	for(it=variant.begin();it!=variant.end();it++){
-		temp = it->first.find(layout[layoutSelect->value()]);
-		if(temp==1){
-			variantSelect->addItem(it->first);
+	vector<const char *> items;
+	items.push_back("Default");
+	int l = catalogue->find(XKB::LAYOUT,layoutSelect->value());
+	if(l>=0){
+		unsigned n;
+		const uint32_t * v = catalogue->variants(l,n);
+		bool all = !filtering || !anyHit[XKB::VARIANT] || hit[XKB::LAYOUT][l]==DIRECT;
+		for(unsigned i=0;i<n;i++){
+			if(all || hit[XKB::VARIANT][v[i]])
+				items.push_back(catalogue->description(XKB::VARIANT,v[i]));
 		}
 	}
+	variantSelect->setItems(items);
 }
 
 void keyboard::fillUpGroupCategory(){
-	groupCategory->deleteAllItems();
-	vector< pair<string,string> >::iterator it;
-	for(it=options.begin();it!=options.end();it++){
-		if(it->second.find(':')==string::npos)
-			groupCategory->addItem(it->first);
+	vector<const char *> items;
+	for(unsigned g=0;g<catalogue->groupCount();g++){
+		if(visible(XKB::OPTION,catalogue->groupHeader(g)))
+			items.push_back(catalogue->description(XKB::OPTION,catalogue->groupHeader(g)));
 	}
+	groupCategory->setItems(items);
 }
 
 void keyboard::fillUpGroupOptions(){
-	groupOptions->deleteAllItems();
-	vector< pair<string,string> >::iterator it;
-	for(it=options.begin();it!=options.end();it++){
-		if(!groupCategory->value().compare(it->first)){
-			++it;
-			while(it!=options.end() && it->second.find(':')!=string::npos){
-				groupOptions->addItem(it->first);
-				++it;
-			}
-			break;
+	vector<const char *> items;
+	int i = catalogue->find(XKB::OPTION,groupCategory->value());
+	if(i>=0 && catalogue->group(i)>=0){
+		unsigned n;
+		unsigned first = catalogue->groupOptions(catalogue->group(i),n);
+		bool all = !filtering || !anyHit[XKB::OPTION] || hit[XKB::OPTION][i]==DIRECT;
+		for(unsigned j=first;j<first+n;j++){
+			if(all || hit[XKB::OPTION][j])
+				items.push_back(catalogue->description(XKB::OPTION,j));
 		}
 	}
+	groupOptions->setItems(items);
 }
 
-bool keyboard::writeConf(string &line,bool newNode,string parameter,bool isLastParameter,string extraParam,string value){
-	string pathParam;int error;
-	pathParam.assign(line);
-	if(newNode==true){
-		pathParam.append("[last()+1]/");
-	}else{
-		pathParam.append("[last()]/");
+/* Narrow every combo to what matches the search field. A matching variant
+ * keeps its layout listed, a matching option its group; a kind without any
+ * match stays complete. */
+void keyboard::applySearch(){
+	vector<XKB::Match> hits;
+	search->find(searchField->value(),hits);
+	filtering = !searchField->value().empty();
+	for(int k=0;k<XKB::KINDS;k++){
+		hit[k].assign(catalogue->count((XKB::Kind)k),HIDDEN);
+		anyHit[k] = false;
 	}
-	pathParam.append(parameter);
-	if(isLastParameter){
-		pathParam.append("[last()+1]");
-	}else{
-		pathParam.append("[last()]");
+	for(unsigned i=0;i<hits.size();i++){
+		hit[hits[i].kind][hits[i].item] = DIRECT;
+		anyHit[hits[i].kind] = true;
+		int parent = -1;
+		if(hits[i].kind==XKB::VARIANT)
+			parent = catalogue->layoutOf(hits[i].item);
+		if(hits[i].kind==XKB::OPTION && catalogue->group(hits[i].item)>=0)
+			parent = catalogue->groupHeader(catalogue->group(hits[i].item));
+		XKB::Kind kind = hits[i].kind==XKB::VARIANT ? XKB::LAYOUT : XKB::OPTION;
+		if(parent>=0 && hit[kind][parent]==HIDDEN){
+			hit[kind][parent] = VIA_CHILD;
+			anyHit[kind] = true;
+		}
 	}
-	pathParam.append(extraParam);
-	cout<<pathParam<<endl;
-	error = aug_set(aug,pathParam.c_str(),value.c_str());
-	
-	if(error==-1)
-		return false;
-	return true;
+	fillUpLayoutSelect();
+	fillUpVariant();
+	fillUpModelSelect();
+	fillUpGroupCategory();
+	fillUpGroupOptions();
 }
-bool keyboard::simpleWriteConf(){
-	char **match;int i=0,j=0,pos=0;string line,subPath,pathParam;
-	int error;
-	string layoutVal = layout[layoutSelect->value()];
-	int cnt = aug_match(aug,"/files/etc/X11/xorg.conf.d/*/InputClass/MatchIsKeyboard",&match);
-	for(i=0;i<cnt-1;i++){
-		if(strcmp(match[i],match[i+1])<0)
-			j = i+1;
+
+/* Put the layouts the locale suggests on top of the simple mode list, the
+ * first of them ends up selected. */
+void keyboard::preselectLayouts(){
+	if(localeLoader.joinable())
+		localeLoader.join();
+	const char * locale = setlocale(LC_CTYPE,NULL);
+	vector<XKB::LayoutRef> likely;
+	locales->suggest(locale!=NULL ? locale : "",likely);
+	vector<const char *> items;
+	vector<bool> taken(catalogue->count(XKB::LAYOUT),false);
+	for(unsigned i=0;i<likely.size();i++){
+		int l = catalogue->findCode(XKB::LAYOUT,likely[i].layout);
+		if(!likely[i].variant.empty() || l<0 || taken[l])
+			continue;
+		taken[l] = true;
+		items.push_back(catalogue->description(XKB::LAYOUT,l));
 	}
-	if(cnt)
-		line.assign(match[j]);
-	else
-		line.assign("/files/etc/X11/xorg.conf.d/99-saxkeyboard.conf/InputClass");
-
-	subPath.assign("InputClass");
-	pos = line.find(subPath);
-	line.erase(pos+subPath.length(),line.size());
-	writeConf(line,true,"Identifier",false,"","SaXKeyBoardConf") ? cout<<"no error\n" : cout<<"error\n";
-	writeConf(line,false,"Option",false,"","XkbLayout") ? cout<<"no error\n" : cout<<"error\n";
-	writeConf(line,false,"Option",false,"/value",layoutVal.c_str()) ? cout<<"no error\n" : cout<<"error\n";
-
-	error = aug_save(aug);
-	if(error==-1){
-		aug_print(aug,stdout,"/augeas//error");
-		return false;
+	if(items.empty())
+		return;
+	for(unsigned i=0;i<taken.size();i++){
+		if(!taken[i])
+			items.push_back(catalogue->description(XKB::LAYOUT,i));
 	}
-	return true;
+	layoutSelect->setItems(items);
+}
+
+bool keyboard::visible(XKB::Kind kind,unsigned i){
+	return !filtering || !anyHit[kind] || hit[kind][i]!=HIDDEN;
+}
+
+string keyboard::codeOf(XKB::Kind kind,const string &description){
+	int i = catalogue->find(kind,description);
+	return i<0 ? "" : catalogue->code(kind,i);
+}
+
+bool keyboard::simpleWriteConf(){
+	string layoutVal = codeOf(XKB::LAYOUT,layoutSelect->value());
+	string file = store->sectionFile("InputClass","MatchIsKeyboard","on","/etc/X11/xorg.conf.d/99-saxkeyboard.conf");
+
+	Conf::Transaction t(store);
+	t.beginSection(file,"InputClass","SaXKeyBoardConf");
+	t.option("XkbLayout",layoutVal);
+	return t.commit();
 }
 
 bool keyboard::expertWriteConf(){
-	vector< pair<string,string> > lvg;
-	vector< pair<string,string> >::iterator it,it1;
-	lvg = layoutTable->getItems();
-	string l,v,g,m;
-	for(it=lvg.begin();it!=lvg.end();it++){
-		cout<<layout[it->first]<<'\t'<<variant[it->second]<<endl;
-		l.append(layout[it->first]);l.push_back(',');
-		v.append(variant[it->second]);v.push_back(',');
-	}
-	l.erase(l.size()-1);
-	v.erase(v.size()-1);
-	cout<<l<<'\t'<<v<<endl;
-	m = model[modelSelect->value()];
-	cout<<m<<endl;
-	lvg=groupTable->getItems();
-	for(it=lvg.begin();it!=lvg.end();it++){
-		for(it1=options.begin();it1!=options.end();it1++){	
-			if(it1->first==it->second){
-				cout<<it1->first<<'\t'<<it->second<<'\t'<<it1->second<<endl;
-				g.append(it1->second);g.push_back(',');
-				break;
-			}
-		}	
+	keepExpertConf();
+	string l,v,g;
+	for(unsigned i=0;i<settings.layouts.size();i++){
+		if(i>0){
+			l.push_back(',');
+			v.push_back(',');
+		}
+		l.append(settings.layouts[i].first);
+		v.append(settings.layouts[i].second);
 	}
-	g.erase(g.size()-1);
-	cout<<g<<endl;
-
-	char **match;int i=0,j=0,pos=0;string line,subPath,pathParam;
-	int error;
-	string layoutVal = layout[layoutSelect->value()];
-	int cnt = aug_match(aug,"/files/etc/X11/xorg.conf.d/*/InputClass/MatchIsKeyboard",&match);
-	for(i=0;i<cnt-1;i++){
-		if(strcmp(match[i],match[i+1])<0)
-			j = i+1;
+	vector<int> selected;
+	for(unsigned i=0;i<settings.options.size();i++){
+		selected.push_back(catalogue->findCode(XKB::OPTION,settings.options[i]));
+		if(i>0)
+			g.push_back(',');
+		g.append(settings.options[i]);
 	}
-	if(cnt)
-		line.assign(match[j]);
-	else
-		line.assign("/files/etc/X11/xorg.conf.d/99-saxkeyboard.conf/InputClass");
-
-	subPath.assign("InputClass");
-	pos = line.find(subPath);
-	line.erase(pos+subPath.size(),line.size());
-
-	cout<<line<<endl;
-	cout<<subPath;
-
-	writeConf(line,true,"Identifier",false,"","SaXKeyBoardConf") ? cout<<"no error\n" : cout<<"error\n";
-	writeConf(line,false,"Option",true,"","XkbLayout") ? cout<<"no error\n" : cout<<"error\n";
-	writeConf(line,false,"Option",false,"/value",l.c_str()) ? cout<<"no error\n" : cout<<"error\n";
-	writeConf(line,false,"Option",true,"","XkbVariant") ? cout<<"no error\n" : cout<<"error\n";
-	writeConf(line,false,"Option",false,"/value",v.c_str()) ? cout<<"no error\n" : cout<<"error\n";
-	writeConf(line,false,"Option",true,"","XkbOptions") ? cout<<"no error\n" : cout<<"error\n";
-	writeConf(line,false,"Option",false,"/value",g.c_str()) ? cout<<"no error\n" : cout<<"error\n";
-
-	error = aug_save(aug);
-	if(error==-1){
-		aug_print(aug,stdout,"/augeas//error");
+	int first,second;
+	if(!catalogue->validate(selected,first,second)){
+		string group = catalogue->description(XKB::OPTION,catalogue->groupHeader(catalogue->group(first)));
+		label1->setValue(string(_("Only one option allowed in "))+group+": "+catalogue->description(XKB::OPTION,first)+" / "+catalogue->description(XKB::OPTION,second));
 		return false;
 	}
-	return true;
+
+	string file = store->sectionFile("InputClass","MatchIsKeyboard","on","/etc/X11/xorg.conf.d/99-saxkeyboard.conf");
+
+	/* The lens cannot store an empty value, an option without one is
+	 * dropped instead, which Xorg treats the same */
+	Conf::Transaction t(store);
+	t.beginSection(file,"InputClass","SaXKeyBoardConf");
+	t.option("XkbLayout",l);
+	if(v.find_first_not_of(',')==string::npos)
+		t.unsetOption("XkbVariant");
+	else
+		t.option("XkbVariant",v);
+	if(g.empty())
+		t.unsetOption("XkbOptions");
+	else
+		t.option("XkbOptions",g);
+	if(t.commit())
+		return true;
+	label1->setValue(_("Could not write the configuration"));
+	return false;
 }
 
 
-vector<string> keyboard::match(string p,string v){
-	int cnt;
-	const char *pattern = p.c_str();
-	const char *value = v.c_str();
-	char **matches;
-	vector<string> s;
-	bool filter = (value != NULL) && (strlen(value) > 0);
-	cnt = aug_match(aug, pattern, &matches);
-    	if (cnt < 0) {
-        	printf("  (error matching %s)\n", pattern);
-	        goto done;
-    	}
-    	if (cnt == 0) {
-        	goto done;
-    	}
-	for (int i=0; i < cnt; i++) {
-        	const char *val;
-        	aug_get(aug, matches[i], &val);
-        	if (val == NULL)
-            		val = "(none)";
-        	if (filter) {
-            		if (!strcmp(value, val)){
-                		printf("%s\n", matches[i]);
-				s.push_back(matches[i]);
-			}
-        	} else {
-            		printf("%s = %s\n", matches[i], val);
-        	}
-    	}
-	done:
-    	for (int i=0; i < cnt; i++)
-        	free(matches[i]);
-  	free(matches);
-	return s;
+/* The last keyboard InputClass with a layout, else the last InputClass
+ * with a layout whatever it matches */
+int keyboard::keyboardSection(){
+	int section = store->lastMatching("InputClass","MatchIsKeyboard","on");
+	if(section>=0 && store->index().option("XkbLayout",section)!=NULL)
+		return section;
+	const vector<Conf::OptionRef> &refs = store->index().option("XkbLayout");
+	for(int i=refs.size()-1;i>=0;i--){
+		if(store->sections()[refs[i].section].type=="InputClass")
+			return refs[i].section;
+	}
+	return -1;
 }
 
 void keyboard::loadSimpleConf(){
-	vector<string> matches = match("/files/etc/X11/xorg.conf.d/*/InputClass/Option","XkbLayout");
-	if(matches.size()==0){
-		cerr<<"No Keyboard file exists, will load the default one"<<endl;
-		return;
+	int i = catalogue->findCode(XKB::LAYOUT,settings.layout);
+	if(i>=0){
+		string selection = catalogue->description(XKB::LAYOUT,i);
+		layoutSelect->setValue(selection);
 	}
-	const char *match;int cnt;
-	string temp = matches.back();
-	temp.append("/value");
-	cnt = aug_get(aug,temp.c_str(),&match);
-	if(cnt==0 || cnt==-1){
-		cerr<<"No matching nodes or illegal path expression";
+	i = catalogue->findCode(XKB::LAYOUT,settings.current);
+	if(i<0)
 		return;
-	}
-	string m = match;
-	m = m.substr(0,m.find_first_of(','));
-
-	map<string,string>::iterator it;
-	for(it=layout.begin();it!=layout.end();it++){
-		if(m==it->second){
-			cout<<it->first<<endl;
-			break;
-		}
-	}
-	string x = "Your Current default selection is "+it->first + " and you can find detailed info in expert mode";
+	cout<<catalogue->description(XKB::LAYOUT,i)<<endl;
+	string x = "Your Current default selection is "+string(catalogue->description(XKB::LAYOUT,i)) + " and you can find detailed info in expert mode";
 	showDefaultLayout->setValue(x);
 }
 
+/* A layout picked in simple mode replaces the first row of the expert
+ * table, the remaining rows are left alone. */
+void keyboard::keepSimpleConf(){
+	string layout = codeOf(XKB::LAYOUT,layoutSelect->value());
+	if(layout.empty() || layout==settings.layout)
+		return;
+	settings.layout = layout;
+	if(settings.layouts.empty())
+		settings.layouts.push_back(make_pair(layout,string()));
+	else
+		settings.layouts[0] = make_pair(layout,string());
+}
+
 vector<string> keyboard::parseOption(const char *value){
 	vector<string> x;
 	string temp;
@@ -524,102 +588,83 @@ vector<string> keyboard::parseOption(const char *value){
 }
 
 void keyboard::loadExpertConf(){
-	vector<string> lMatches = match("/files/etc/X11/xorg.conf.d/*/InputClass/Option","XkbLayout");
-	vector<string> vMatches = match("/files/etc/X11/xorg.conf.d/*/InputClass/Option","XkbVariant");
-	vector<string> oMatches = match("/files/etc/X11/xorg.conf.d/*/InputClass/Option","XkbOptions");
-	const char * match;string temp;int cnt;unsigned i;
-	if(lMatches.size()==0){
-		cerr<<"No Layout, so need to write a new configuration"<<endl;
-		return;
-	}
-	temp = lMatches.back();
-	temp = temp.append("/value");
-	cnt = aug_get(aug,temp.c_str(),&match);
-	if(cnt==0 ||cnt==-1){
-		cerr<<"No Matching nodes";
-		return;
+	unsigned i;
+	if(!settings.query.empty()){
+		searchField->setValue(settings.query);
+		applySearch();
 	}
-	vector<string> l = parseOption(match);
-	vector<string> v,o;
-	if(vMatches.size()!=0 && (vMatches.back()>lMatches.back())){
-		temp = vMatches.back();
-		temp.append("/value");
-		cnt = aug_get(aug,temp.c_str(),&match);
-		if(cnt==0||cnt==-1){
-			cerr<<"Error in variants, No Matching Nodes";
-			goto skip;
-		}
-		v = parseOption(match);
-	}
-	if(oMatches.size()==0 || (lMatches.back()>=oMatches.back()))
-		goto skip;
-	
-	temp = oMatches.back();
-	temp.append("/value");
-	cnt = aug_get(aug,temp.c_str(),&match);
-	if(cnt==0 || cnt==-1){
-		cerr<<"Error in groups,No Matching nodes";
-		goto skip;
-	}
-	o  = parseOption(match);
-
-skip:
-	
-	for(i=0;i<v.size();i++){
-		if(v[i]==""){
-			v[i] = "Default";
-		}
+	int m = catalogue->findCode(XKB::MODEL,settings.model);
+	if(m>=0){
+		string model = catalogue->description(XKB::MODEL,m);
+		modelSelect->setValue(model);
 	}
-	for(;i<l.size();i++){
-		v.push_back("Default");
+	if(settings.layouts.empty()){
+		cerr<<"No Layout, so need to write a new configuration"<<endl;
+		return;
 	}
 
-	map<string,string>::iterator it;
 	string var,lay;
-	cout<<"Checking for values"<<endl;	
-	for(i=0;i<l.size();i++){
-		if(l[i]=="")continue;
-		for(it=layout.begin();it!=layout.end();it++){
-			if(!it->second.compare(l[i])){//|| !it->second.compare(l[i].append(' '))){
-				lay = it->first;
-				break;
-			}
-		}
-		for(it=variant.begin();it!=variant.end();it++){
-			if(v[i]=="Default"){
-				cout<<"Default"<<endl;
-				var = "Default";
-				break;
-			}
-			 if(it->second==v[i]){
-				cout<<it->first<<endl;
-				var = it->first;
-				break;
-			}
+	cout<<"Checking for values"<<endl;
+	colNo = 0;
+	for(i=0;i<settings.layouts.size();i++){
+		int j = catalogue->findCode(XKB::LAYOUT,settings.layouts[i].first);
+		if(j<0)
+			continue;
+		lay = catalogue->description(XKB::LAYOUT,j);
+		var = "Default";
+		int k = catalogue->findVariant(j,settings.layouts[i].second);
+		if(k>=0){
+			var = catalogue->description(XKB::VARIANT,k);
+			cout<<var<<endl;
 		}
 		char * temp = new char[5];
 		sprintf(temp,"%d",++colNo);
 		xcolNo = temp;
 		layoutTable->addItem(xcolNo,lay,var);
 	}
-	vector< pair<string,string> >::iterator it1;
 	string gc,gv;
-	for(i=0;i<o.size();i++){
-		for(it1=options.begin();it1!=options.end();it1++){	
-			if(o[i]==it1->second){
-				cout<<it1->second;
-				gv = it1->first;
-				while(it1->second.find(':')!=string::npos){
-					--it1;
-				}
-				cout<<it1->second;
-				gc= it1->first;
-				groupTable->addItem(gc,gv);
-				break;
-			}
+	for(i=0;i<settings.options.size();i++){
+		int j = catalogue->findCode(XKB::OPTION,settings.options[i]);
+		if(j<0 || catalogue->group(j)<0)
+			continue;
+		cout<<settings.options[i];
+		gv = catalogue->description(XKB::OPTION,j);
+		gc = catalogue->description(XKB::OPTION,catalogue->groupHeader(catalogue->group(j)));
+		groupTable->addItem(gc,gv);
+	}
+}
+
+/* Take the table rows back into settings as codes, variants are looked up
+ * within the layout of their row. */
+void keyboard::keepExpertConf(){
+	vector< pair<string,string> > rows = layoutTable->getItems();
+	settings.layouts.clear();
+	for(unsigned i=0;i<rows.size();i++){
+		int l = catalogue->find(XKB::LAYOUT,rows[i].first);
+		if(l<0)
+			continue;
+		string variant;
+		unsigned n;
+		const uint32_t * v = catalogue->variants(l,n);
+		for(unsigned j=0;j<n;j++){
+			if(rows[i].second==catalogue->description(XKB::VARIANT,v[j]))
+				variant = catalogue->code(XKB::VARIANT,v[j]);
 		}
+		settings.layouts.push_back(make_pair(string(catalogue->code(XKB::LAYOUT,l)),variant));
+	}
+	if(!settings.layouts.empty())
+		settings.layout = settings.layouts[0].first;
+	settings.model = codeOf(XKB::MODEL,modelSelect->value());
+	rows = groupTable->getItems();
+	settings.options.clear();
+	for(unsigned i=0;i<rows.size();i++){
+		int header = catalogue->find(XKB::OPTION,rows[i].first);
+		int j = header<0 ? -1 : catalogue->find(XKB::OPTION,rows[i].second,catalogue->group(header));
+		if(j>=0)
+			settings.options.push_back(catalogue->code(XKB::OPTION,j));
 	}
-}	
+	settings.query = searchField->value();
+}
 
 int main(){
 	
@@ -628,8 +673,8 @@ int main(){
 	textdomain("sax3-keyboard");
 
 	keyboard * kb = new keyboard();
-	kb->drawLayout();
 	kb->loadConf();
+	kb->drawLayout();
 	while(kb->respondToEvent());
 	delete kb;	
 
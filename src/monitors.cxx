@@ -1,46 +1,69 @@
 
-#include<dirent.h>
 #include<stdlib.h>
 #include<string>
 #include<string.h>
 #include<stdio.h>
-#include<fstream>
 #include<vector>
+#include<algorithm>
 #include<locale.h>
 #include<libintl.h>
 
-extern "C"{
-#include<augeas.h>
-}
-
 #include"ui/yuifactory.h"
+#include"config/configstore.h"
+#include"config/transaction.h"
+#include"display/detector.h"
+#include"display/edid.h"
+#include"display/modetable.h"
+#include"display/capabilities.h"
+#include"display/recommender.h"
+#include"display/hwdata.h"
+#include"display/layout.h"
+#include"display/validator.h"
 
 #define _(STRING) gettext(STRING)
 using namespace std;
 
 class Monitors{
 	vector<string> driverList;
-	vector<string> resolutionList;
-
-	augeas * aug;char *root,*loadpath;unsigned int flag;
+	vector<Display::Mode> modeList;
+
+	Conf::ConfigStore * store;
+	Display::Detector detector;
+	Display::Recommender recommender;
+	Display::HwData hwdata;
+	Display::Edid edid;
+	Display::Capabilities capabilities;
+	Display::Layout layout;
+	Display::Validator validator;
+	vector<string> optionNames;
 	
 	UI::YUIFactory * factory;
 	UI::yDialog * dialog;
 	UI::yVLayout * vL1,*vL2,*vL3,*vL4;
 	UI::yHLayout * hL1,*hL2,*hL3,*hL4,*hL5;
 	UI::yPushButton * ok,*cancel;
+	vector<UI::yLabel*> hardwareLabels;
 	UI::yComboBox * driverCombo,*resolutionCombo,*depthCombo;
 	UI::yIntField * horizontalLow,*horizontalHigh;
 	UI::yIntField * verticalLow,*verticalHigh;
 	UI::yCheckBox * disableDPMS,*enableAdvance,*customCVT;
+	UI::yReplacePoint * optionPoint;
+	UI::yVLayout * optionLayout;
+	vector<UI::yCheckBox*> optionBoxes;
+	UI::yComboBox * primaryCombo;
+	vector<UI::yComboBox*> placeCombos,rotateCombos;
+	vector<UI::yIntField*> placeX,placeY;
 	UI::yIntField * xAxis,*yAxis,*refreshRate;
 	void fillUpDriverCombo();
 	void fillUpResolutionCombo();
 	void fillUpDepthCombo();
-	void separateResolution(string&);
-	void saveConf();
-	string calculateCVT();
-	bool writeConf(string &line,bool newNode,string parameter,bool isLastParameter,string extraParam,string value);
+	void fillUpHardware();
+	void fillUpOptions();
+	void fillUpLayout();
+	bool keepLayout();
+	bool validateLayout();
+	bool saveConf();
+	Display::Timing calculateMode();
 	public:
 	Monitors();
 	void detectDrivers();
@@ -49,43 +72,58 @@ class Monitors{
 	bool respondToEvent();
 };
 
-string Monitors::calculateCVT(){
-	string cvt = "cvt ";
-	if(!customCVT->isChecked()){
-	string resolution = resolutionCombo->value();
-	string x = resolution.substr(0,resolution.find('x'));
-	string y = resolution.substr(resolution.find('x')+1,resolution.size());
-	cvt.append(x);
-	cvt.push_back(' ');
-	cvt.append(y);
-
-	}else{
-		char * x = new char[10];
-		sprintf(x,"%d",xAxis->value());
-		cvt.append(x);	
-		cvt.push_back(' ');		
-		char * y = new char[10];
-		sprintf(y,"%d",yAxis->value());
-		cvt.append(y);
-		cvt.push_back(' ');\
-		char * ref = new char[10];
-		sprintf(ref,"%d",refreshRate->value());
-		cvt.append(ref);
-		cvt.push_back(' ');
+static string modeLabel(const Display::Mode &m){
+	char label[40];
+	sprintf(label,"%ux%u%s @ %d Hz",m.width,m.height,m.interlaced ? "i" : "",(int)(m.refresh+0.5));
+	return label;
+}
 
+/* What the placement combo of output i offers: the origin, the position
+ * given in its X and Y fields, every side of every other output and
+ * switched off, in the order of the labels */
+static void placementChoices(const Display::Layout &layout,unsigned i,vector<string> &labels,vector< pair<Display::Relation,int> > &choices){
+	static const char * sides[] = {"Right of","Left of","Above","Below"};
+	static const Display::Relation relations[] = {Display::RIGHT_OF,Display::LEFT_OF,Display::ABOVE,Display::BELOW};
+	const vector<Display::Placement> &list = layout.placements();
+	labels.push_back(_("At the origin"));
+	choices.push_back(make_pair(Display::ORIGIN,-1));
+	labels.push_back(_("At a position"));
+	choices.push_back(make_pair(Display::ABSOLUTE,-1));
+	for(unsigned j=0;j<list.size();j++){
+		if(j==i)
+			continue;
+		for(unsigned k=0;k<4;k++){
+			labels.push_back(string(_(sides[k]))+" "+layout.label(list[j]));
+			choices.push_back(make_pair(relations[k],(int)j));
+		}
 	}
-	cvt.append(" > /tmp/cvt.tmp");
-	system(cvt.c_str());
-	ifstream file("/tmp/cvt.tmp");
-	if(file.is_open()){
-		if(file.good()){
-			getline(file,cvt);
-			getline(file,cvt);
+	labels.push_back(_("Switched off"));
+	choices.push_back(make_pair(Display::OFF,-1));
+}
+
+static const char * rotationLabels[] = {"Normal","Left","Right","Inverted"};
+
+Display::Timing Monitors::calculateMode(){
+	Display::Timing t;
+	if(!customCVT->isChecked()){
+		string label = resolutionCombo->value();
+		unsigned i = 0;
+		while(i<modeList.size() && modeLabel(modeList[i])!=label)
+			i++;
+		/* A label that is not a detected mode gets the preferred mode, and
+		 * with nothing detected the 1024x768 DMT mode any monitor takes */
+		if(i==modeList.size() && !modeList.empty()){
+			cerr<<"Unknown mode "<<label<<", using "<<modeLabel(modeList[0])<<endl;
+			i = 0;
 		}
+		if(i<modeList.size())
+			t = Display::modeTiming(edid,modeList[i].width,modeList[i].height,modeList[i].refresh,modeList[i].interlaced);
+		else
+			t = Display::modeTiming(edid,1024,768,60,false);
+	}else{
+		t = Display::modeTiming(edid,xAxis->value(),yAxis->value(),refreshRate->value(),false);
 	}
-	cvt = cvt.substr(cvt.find(' ')+1,string::npos);
-	cout<<cvt;
-	return cvt;
+	return t;
 }
 void Monitors::fillUpDepthCombo(){
 	depthCombo->addItem("24");
@@ -93,34 +131,221 @@ void Monitors::fillUpDepthCombo(){
 }
 
 void Monitors::fillUpResolutionCombo(){
-	for(int i=0;i<resolutionList.size();i++)
-		resolutionCombo->addItem(resolutionList[i]);
+	for(unsigned i=0;i<modeList.size();i++)
+		resolutionCombo->addItem(modeLabel(modeList[i]));
 }
 
-void Monitors::separateResolution(string &temp){
-	temp = temp.erase(0,temp.find_first_not_of(' '));
-	temp = temp.erase(temp.find_first_of(' '),string::npos);
+/* Every size and rate of the primary output. Taken from its
+ * EDID when that decodes, otherwise from the names the kernel lists, which
+ * carry no rate and count as 60 Hz. Sizes keep the order they come in,
+ * preferred first, and each size lists its highest rate first so the
+ * fastest mode of the native size is the default choice. Modes the
+ * monitor or link cannot take even with reduced blanking are left out. */
+void Monitors::detectResolution(){
+	const Display::Output * output = detector.topology().primary();
+	if(output!=NULL){
+		const Display::Connector &connector = output->connector;
+		vector<Display::Mode> modes;
+		edid = output->edid;
+		capabilities.probe(detector.topology().gpuOf(output)->card,connector,edid);
+		validator.setMonitor(edid);
+		validator.setLink(connector,edid);
+		if(output->decoded && !edid.modes().empty()){
+			cout<<edid.vendor()<<' '<<edid.name()<<endl;
+			modes = edid.modes();
+		}else{
+			for(unsigned j=0;j<connector.modes.size();j++){
+				const string &name = connector.modes[j];
+				Display::Mode m;
+				if(sscanf(name.c_str(),"%ux%u",&m.width,&m.height)!=2)
+					continue;
+				m.refresh = 60;
+				m.interlaced = name[name.size()-1]=='i';
+				m.preferred = j==0;
+				modes.push_back(m);
+			}
+		}
+		for(unsigned j=0;j<modes.size();j++){
+			unsigned k = 0;
+			while(k<modeList.size() && !(modeList[k].width==modes[j].width && modeList[k].height==modes[j].height))
+				k++;
+			while(k<modeList.size() && modeList[k].width==modes[j].width && modeList[k].height==modes[j].height
+					&& (modeList[k].interlaced<modes[j].interlaced || (modeList[k].interlaced==modes[j].interlaced && modeList[k].refresh>modes[j].refresh+0.5)))
+				k++;
+			if(k<modeList.size() && modeLabel(modeList[k])==modeLabel(modes[j]))
+				continue;
+			modeList.insert(modeList.begin()+k,modes[j]);
+		}
+	}
+	for(unsigned i=0;i<modeList.size();){
+		const Display::Mode &m = modeList[i];
+		Display::Timing t = Display::modeTiming(edid,m.width,m.height,m.refresh,m.interlaced);
+		if(validator.fit(t)){
+			i++;
+			continue;
+		}
+		cerr<<"Dropping "<<modeLabel(m)<<": "<<Display::Validator::describe(validator.check(t))<<endl;
+		modeList.erase(modeList.begin()+i);
+	}
 }
 
-void Monitors::detectResolution(){
-	string temp;int flag=0;
-	ifstream file("/tmp/sax-xrandr.tmp");
-	cout<<"IN DETECT RESOLUTION---->";
-	if(file.is_open()){
-		cout<<"File opened";
-		while(file.good()){
-			getline(file,temp);
-			if(temp.find(' ')!=0 && flag)
-			break;
-			if(temp.find(' ')==0){
-				flag=1;
-				separateResolution(temp);
-				resolutionList.push_back(temp);
+/* Driver options the selected driver offers on this card and monitor.
+ * Rebuilt when the driver changes, options both drivers share stay ticked. */
+void Monitors::fillUpOptions(){
+	vector<string> checked;
+	for(unsigned i=0;i<optionBoxes.size();i++){
+		if(optionBoxes[i]->isChecked())
+			checked.push_back(optionNames[i]);
+		delete optionBoxes[i];
+	}
+	optionBoxes.clear();
+	delete optionLayout;
+	optionNames = capabilities.options(driverCombo->value());
+	optionLayout = factory->createVLayout(optionPoint);
+	for(unsigned i=0;i<optionNames.size();i++){
+		bool on = find(checked.begin(),checked.end(),optionNames[i])!=checked.end();
+		optionBoxes.push_back(factory->createCheckBox(optionLayout,optionNames[i],on));
+	}
+	optionPoint->showChild();
+}
+
+/* The probed topology, one line per card with its PCI names and kernel
+ * driver followed by its connected outputs with the monitor's manufacturer
+ * and name */
+void Monitors::fillUpHardware(){
+	const vector<Display::Gpu> &gpus = detector.topology().gpus();
+	for(unsigned i=0;i<gpus.size();i++){
+		const Display::Card &c = gpus[i].card;
+		string vendor = hwdata.vendor(c.vendor),device = hwdata.device(c.vendor,c.device);
+		char ids[16];
+		sprintf(ids,"%04x:%04x",c.vendor,c.device);
+		string label = c.name+": "+(vendor.empty() ? string(ids) : vendor+" "+(device.empty() ? string(ids) : device));
+		if(!c.driver.empty())
+			label += " ("+c.driver+")";
+		hardwareLabels.push_back(factory->createLabel(vL1,label));
+		for(unsigned j=0;j<gpus[i].outputs.size();j++){
+			const Display::Output &o = gpus[i].outputs[j];
+			if(o.connector.status!=Display::CONNECTED)
+				continue;
+			label = "    "+o.connector.name+": ";
+			if(o.decoded){
+				string maker = hwdata.manufacturer(o.edid.vendor());
+				label += (maker.empty() ? o.edid.vendor() : maker)+" "+o.edid.name();
+			}else{
+				label += _("Unknown monitor");
+			}
+			hardwareLabels.push_back(factory->createLabel(vL1,label));
+		}
+	}
+}
+
+/* With more than one connected output: which one is primary and, per
+ * output, where it goes and how it is turned */
+void Monitors::fillUpLayout(){
+	const vector<Display::Placement> &list = layout.placements();
+	if(list.size()<2)
+		return;
+	primaryCombo = factory->createComboBox(vL1,_("Primary output"));
+	for(unsigned i=0;i<list.size();i++)
+		primaryCombo->addItem(layout.label(list[i]));
+	for(unsigned i=0;i<list.size();i++){
+		UI::yHLayout * row = factory->createHLayout(vL1);
+		vector<string> labels;
+		vector< pair<Display::Relation,int> > choices;
+		placementChoices(layout,i,labels,choices);
+		UI::yComboBox * place = factory->createComboBox(row,layout.label(list[i]));
+		for(unsigned j=0;j<labels.size();j++){
+			place->addItem(labels[j]);
+			if(choices[j].first==list[i].relation && choices[j].second==list[i].relativeTo)
+				place->setValue(labels[j]);
+		}
+		placeX.push_back(factory->createIntField(row,_("X"),0,32767,max(list[i].x,0)));
+		placeY.push_back(factory->createIntField(row,_("Y"),0,32767,max(list[i].y,0)));
+		UI::yComboBox * rotate = factory->createComboBox(row,_("Rotation"));
+		for(unsigned j=0;j<4;j++)
+			rotate->addItem(_(rotationLabels[j]));
+		placeCombos.push_back(place);
+		rotateCombos.push_back(rotate);
+	}
+}
+
+/* Read the layout back from the dialog, the first output runs the chosen
+ * mode, and resolve it into positions */
+bool Monitors::keepLayout(){
+	vector<Display::Placement> &list = layout.placements();
+	Display::Timing mode = calculateMode();
+	if(list.empty()){
+		Display::Placement p;
+		p.gpu = 0;
+		p.relation = Display::ORIGIN;
+		p.relativeTo = -1;
+		p.x = p.y = 0;
+		p.rotation = Display::NORMAL;
+		p.primary = false;
+		list.push_back(p);
+	}
+	list[0].mode = mode;
+	if(list.size()<2)
+		return validateLayout() && layout.arrange();
+	string primary = primaryCombo->value();
+	for(unsigned i=0;i<list.size();i++){
+		vector<string> labels;
+		vector< pair<Display::Relation,int> > choices;
+		placementChoices(layout,i,labels,choices);
+		string value = placeCombos[i]->value();
+		for(unsigned j=0;j<labels.size();j++){
+			if(labels[j]==value){
+				list[i].relation = choices[j].first;
+				list[i].relativeTo = choices[j].second;
 			}
 		}
-	}else
-		cout<<"Not opened";
+		if(list[i].relation==Display::ABSOLUTE){
+			list[i].x = placeX[i]->value();
+			list[i].y = placeY[i]->value();
+		}
+		value = rotateCombos[i]->value();
+		for(unsigned j=0;j<4;j++){
+			if(value==_(rotationLabels[j]))
+				list[i].rotation = (Display::Rotation)j;
+		}
+		list[i].primary = layout.label(list[i])==primary;
+		if(list[i].primary && list[i].relation==Display::OFF){
+			cerr<<"The primary output cannot be switched off"<<endl;
+			return false;
+		}
+	}
+	return validateLayout() && layout.arrange();
+}
 
+/* Every output's mode against its monitor and link, the first also
+ * against the sync ranges of the advanced settings. A mode out of range
+ * is switched to reduced blanking when that fits, else nothing is saved. */
+bool Monitors::validateLayout(){
+	vector<Display::Placement> &list = layout.placements();
+	const vector<Display::Gpu> &gpus = detector.topology().gpus();
+	for(unsigned i=0;i<list.size();i++){
+		Display::Placement &p = list[i];
+		if(p.relation==Display::OFF)
+			continue;
+		Display::Validator v;
+		for(unsigned j=0;p.gpu<gpus.size() && j<gpus[p.gpu].outputs.size();j++){
+			const Display::Output &o = gpus[p.gpu].outputs[j];
+			if(o.connector.name!=p.output)
+				continue;
+			v.setMonitor(o.edid);
+			v.setLink(o.connector,o.edid);
+		}
+		if(i==0 && enableAdvance->isChecked())
+			v.setUser(horizontalLow->value(),horizontalHigh->value(),verticalLow->value(),verticalHigh->value());
+		string name = p.mode.name;
+		if(!v.fit(p.mode)){
+			cerr<<name<<" does not fit "<<layout.label(p)<<": "<<Display::Validator::describe(v.check(p.mode))<<endl;
+			return false;
+		}
+		if(p.mode.name!=name)
+			cout<<name<<" switched to "<<p.mode.name<<" on "<<layout.label(p)<<endl;
+	}
+	return true;
 }
 
 void Monitors::fillUpDriverCombo(){
@@ -129,61 +354,31 @@ void Monitors::fillUpDriverCombo(){
 }
 Monitors::Monitors(){
         factory = new UI::YUIFactory();
-        aug=NULL;root=NULL;flag=0;loadpath=NULL;
+        optionLayout = NULL;
+        primaryCombo = NULL;
         cout<<"Loading AUgeas";
-        aug = aug_init(root,loadpath,flag);
-        if(aug==NULL){
+        store = new Conf::ConfigStore();
+        if(!store->isLoaded()){
               cout<<"AUGEAS NOT LOADED";
         }
 }
 
+/* Ranked by the recommender from the PCI display controllers, the
+ * kernel modules that can drive them and the Xorg drivers installed */
 void Monitors::detectDrivers(){
-	system("rm /tmp/sax*");
-	system(" xinit `which xrandr` -- :9 -logfile `mktemp --tmpdir sax3.XXXXX` >  /tmp/sax-xrandr.tmp");
-	string temp;
-	struct dirent * ep;
-	DIR * dp;
-	dp = opendir("/tmp/");
-	if(dp!=NULL){
-		while(ep=readdir(dp)){
-			temp = ep->d_name;	
-			if(temp.find("sax3")!=-1 && temp.find(".old")==-1)
-				break;
-		};
-	}
-	temp =temp.insert(0,"/tmp/");
-	cout<<temp;
-	ifstream file(temp.c_str());
-	string temp1;
-	int pos,pos1;
-	if(file.is_open()){
-		while(file.good()){
-			getline(file,temp1);
-			pos = temp1.find("/usr/lib64/xorg/modules/drivers/");
-			pos1 = temp1.find("/usr/lib/xorg/modules/drivers/");
-			string matched;
-			if(pos!=-1 || pos1!=-1){
-				cout<<endl<<"Found atleast one";
-				if(pos!=-1)
-					matched = "/usr/lib64/xorg/modules/drivers/";
-				if(pos1!=-1)
-					matched = "/usr/lib/xorg/modules/drivers/";
-				int next_pos = pos + matched.size();
-				temp1.erase(0,next_pos);
-				next_pos = temp1.find('_');
-				temp1.erase(next_pos,string::npos);
-				cout<<"\t"<<temp1<<endl;
-				driverList.push_back(temp1);
-			}
-		}
-
-	}
-//	driverList.pop_back();
+	if(!detector.scan())
+		cout<<"No DRM devices found";
+	layout.build(detector.topology());
+	recommender.scan();
+	driverList = recommender.drivers();
+	if(driverList.empty())
+		driverList.push_back("modesetting");
 }
 
 void Monitors::initUI(){
 	dialog = factory->createDialog(60,12);
 	vL1 = factory->createVLayout(dialog);
+	fillUpHardware();
 	driverCombo = factory->createComboBox(vL1,_("Select the driver"));	
 	fillUpDriverCombo();
 	vL2 = factory->createVLayout(vL1);
@@ -192,26 +387,38 @@ void Monitors::initUI(){
 	fillUpResolutionCombo();
 	depthCombo = factory->createComboBox(hL1,_("Depth"));
 	fillUpDepthCombo();
+	optionPoint = factory->createReplacePoint(vL1);
+	fillUpOptions();
+	fillUpLayout();
 	enableAdvance = factory->createCheckBox(vL1,_("Enable Advanced Settings"),false);
 	
 	hL2 = factory->createHLayout(vL1);
-	horizontalLow = factory->createIntField(hL2,_("Horizontal Sync Rate(min value)"),30,100,50);
+	const Display::RangeLimits &range = edid.range();
+	int hLow = range.maxHRate ? range.minHRate : 50,hHigh = range.maxHRate ? range.maxHRate : 50;
+	int vLow = range.maxVRate ? range.minVRate : 70,vHigh = range.maxVRate ? range.maxVRate : 70;
+	horizontalLow = factory->createIntField(hL2,_("Horizontal Sync Rate(min value)"),min(30,hLow),max(100,hHigh),hLow);
 	horizontalLow->setDisabled();
-	horizontalHigh = factory->createIntField(hL2,_("Horizontal Sync Rate(max value)"),30,100,50);
+	horizontalHigh = factory->createIntField(hL2,_("Horizontal Sync Rate(max value)"),min(30,hLow),max(100,hHigh),hHigh);
 	horizontalHigh->setDisabled();
 	hL3 = factory->createHLayout(vL1);
-	verticalLow = factory->createIntField(hL3,_("Vertical Refresh Rate(min value)"),50,120,70);
+	verticalLow = factory->createIntField(hL3,_("Vertical Refresh Rate(min value)"),min(50,vLow),max(120,vHigh),vLow);
 	verticalLow->setDisabled();
-	verticalHigh = factory->createIntField(hL3,_("Vertical Refresh Rate(max value)"),50,120,70);
+	verticalHigh = factory->createIntField(hL3,_("Vertical Refresh Rate(max value)"),min(50,vLow),max(120,vHigh),vHigh);
 	verticalHigh->setDisabled();
 	
+	int width = 1280,height = 1024,rate = 60;
+	if(!modeList.empty()){
+		width = modeList[0].width;
+		height = modeList[0].height;
+		rate = (int)(modeList[0].refresh+0.5);
+	}
 	customCVT = factory->createCheckBox(vL1,_("I want my own CVT"),false);
 	hL5 = factory->createHLayout(vL1);
-	xAxis = factory->createIntField(hL5,_("X Axis"),400,1280,4000);
+	xAxis = factory->createIntField(hL5,_("X Axis"),400,max(4000,width),width);
 	xAxis->setDisabled();
-	yAxis = factory->createIntField(hL5,_("Y Axis"),400,1280,3000);
+	yAxis = factory->createIntField(hL5,_("Y Axis"),400,max(3000,height),height);
 	yAxis->setDisabled();
-	refreshRate = factory->createIntField(hL5,_("Refresh Rate"),20,60,200);
+	refreshRate = factory->createIntField(hL5,_("Refresh Rate"),20,max(200,rate),rate);
 	refreshRate->setDisabled();
 	hL4 = factory->createHLayout(vL1);
 	ok = factory->createPushButton(hL4,_("Ok"));
@@ -221,6 +428,10 @@ void Monitors::initUI(){
 bool Monitors::respondToEvent(){
 	while(1){
 		dialog->wait();
+		if(dialog->eventWidget()==driverCombo->getElement()){
+			fillUpOptions();
+			dialog->redraw();
+		}
 		if(dialog->eventWidget()==enableAdvance->getElement()){
 			if(!enableAdvance->isChecked()){
 				horizontalLow->setDisabled();
@@ -246,8 +457,8 @@ bool Monitors::respondToEvent(){
 			}
 		}
 		if(dialog->eventWidget()==ok->getElement()){
-			saveConf();
-			break;
+			if(saveConf())
+				break;
 		}
 		if(dialog->eventWidget()==cancel->getElement()){
 			break;
@@ -256,119 +467,131 @@ bool Monitors::respondToEvent(){
 	return false;
 }
 
-void Monitors::saveConf(){
-	char **match;int i=0,j=0,pos=0;string line,subPath,pathParam;
-        int error;
-
-        int cnt = aug_match(aug,"/files/etc/X11/xorg.conf.d/*/Monitor/*",&match);
-
-        for(i=0;i<cnt-1;i++){
-                if(strcmp(match[i],match[i+1])<0)
-                        j = i;
-        }
-
-        if(cnt)
-                line.assign(match[j]);
-        else
-                line.assign("/files/etc/X11/xorg.conf.d/99-saxmonitors.conf/Monitor");
-
-        subPath.assign("Monitor");
-        pos = line.find(subPath);
-        line.erase(pos+subPath.length(),line.size());
-	
-	writeConf(line,true,"Identifier",false,"","SaX3-monitor") ? cout<<"no error\n" : cout<<"error\n";
-
-	if(enableAdvance->isChecked()){
-		cout<<"In Enable Advanced";
-		string horiz,vert;
-		char * temp = new char[10];
-		sprintf(temp,"%d",horizontalLow->value());
-		horiz = temp;
-		horiz.append("-");
-		sprintf(temp,"%d",horizontalHigh->value());
-		horiz.append(temp);
-		writeConf(line,false,"HorizSync",false,"",horiz.c_str());
-
-		sprintf(temp,"%d",verticalLow->value());
-		vert = temp;
-		vert.append("-");
-		sprintf(temp,"%d",horizontalHigh->value());
-		vert.append(temp);
-		writeConf(line,false,"VertRefresh",false,"",vert.c_str());
+/* One Monitor section per output and one Device section per card in use,
+ * all in one transaction. A single output keeps the three sections it
+ * always had. Further cards join the screen of the primary card as GPU
+ * screens through Inactive entries of the layout. Whatever an earlier
+ * multihead save left and no longer applies is removed again. */
+bool Monitors::saveConf(){
+	if(!keepLayout())
+		return false;
+	const vector<Display::Placement> &list = layout.placements();
+	const vector<Display::Card> &cards = layout.gpus();
+	string monitorFile = store->sectionFile("Monitor","*","/etc/X11/xorg.conf.d/99-saxmonitors.conf");
+	string deviceFile = store->sectionFile("Device","*","/etc/X11/xorg.conf.d/99-saxdevice.conf");
+	string screenFile = store->sectionFile("Screen","*","/etc/X11/xorg.conf.d/99-saxscreen.conf");
+
+	Conf::Transaction t(store);
+	static const char * relationOptions[] = {"RightOf","LeftOf","Above","Below","Position"};
+	for(unsigned i=0;i<list.size();i++){
+		const Display::Placement &p = list[i];
+		t.beginSection(monitorFile,"Monitor",layout.monitorName(p));
+		if(i==0 && enableAdvance->isChecked()){
+			char temp[24];
+			sprintf(temp,"%d-%d",horizontalLow->value(),horizontalHigh->value());
+			t.set("HorizSync",temp);
+			sprintf(temp,"%d-%d",verticalLow->value(),verticalHigh->value());
+			t.set("VertRefresh",temp);
+		}else if(i==0){
+			t.unset("HorizSync");
+			t.unset("VertRefresh");
+		}
+		t.set("Modeline",p.mode.modeline());
+		t.option("PreferredMode",p.mode.name);
+		const char * relation = Display::Layout::relationOption(p.relation);
+		for(unsigned j=0;j<5;j++){
+			if(relation!=NULL && !strcmp(relation,relationOptions[j]))
+				continue;
+			t.unsetOption(relationOptions[j]);
+		}
+		if(p.relation==Display::ABSOLUTE){
+			char position[32];
+			sprintf(position,"%d %d",p.x,p.y);
+			t.option(relation,position);
+		}else if(relation!=NULL){
+			t.option(relation,layout.monitorName(list[p.relativeTo]));
+		}
+		if(p.primary && list.size()>1)
+			t.option("Primary","true");
+		else
+			t.unsetOption("Primary");
+		if(p.rotation!=Display::NORMAL)
+			t.option("Rotate",Display::Layout::rotationValue(p.rotation));
+		else
+			t.unsetOption("Rotate");
+		if(p.relation==Display::OFF)
+			t.option("Enable","false");
+		else
+			t.unsetOption("Enable");
 	}
-	
-	string cvt = calculateCVT();
-	
-	writeConf(line,false,"Modeline",false,"",cvt) ? cout<<"no error\n":cout<<"error\n";
-
-        cnt = aug_match(aug,"/files/etc/X11/xorg.conf.d/*/Device/*",&match);
-
-        for(i=0;i<cnt-1;i++){
-	                if(strcmp(match[i],match[i+1])<0)
-			                        j = i;
-		        }
-
-        if(cnt)
-	                line.assign(match[j]);
-        else
-	                line.assign("/files/etc/X11/xorg.conf.d/99-saxdevice.conf/Device");
-
-        subPath.assign("Device");
-        pos = line.find(subPath);
-        line.erase(pos+subPath.length(),line.size());
-        writeConf(line,true,"Identifier",false,"","SaX3-device") ? cout<<"no error\n" : cout<<"error\n";
-	string temp = driverCombo->value();
-	cout<<temp;
-        writeConf(line,false,"Driver",false,"",temp.c_str()) ? cout<<"no error\n" : cout<<"error\n";
-
-        cnt = aug_match(aug,"/files/etc/X11/xorg.conf.d/*/Screen/*",&match);
-
-        for(i=0;i<cnt-1;i++){
-                        if(strcmp(match[i],match[i+1])<0)
-                                                j = i;
-                        }
-
-        if(cnt)
-                        line.assign(match[j]);
-        else
-                        line.assign("/files/etc/X11/xorg.conf.d/99-saxscreen.conf/Screen");
-
-        subPath.assign("Screen");
-        pos = line.find(subPath);
-        line.erase(pos+subPath.length(),line.size());
-
-        writeConf(line,true,"Identifier",false,"","SaX3-screen") ? cout<<"no error\n" : cout<<"error\n";
-        writeConf(line,false,"Device",false,"","SaX3-device") ? cout<<"no error\n" : cout<<"error\n";
-        writeConf(line,false,"Monitor",false,"","SaX3-monitor") ? cout<<"no error\n" : cout<<"error\n";
-        writeConf(line,false,"DefaultDepth",false,"",depthCombo->value().c_str()) ? cout<<"no error\n" : cout<<"error\n";
-        writeConf(line,false,"Display",true,"/Depth",depthCombo->value().c_str()) ? cout<<"no error\n" : cout<<"error\n";
-	string mode = resolutionCombo->value();mode.append("_60.00");
-        writeConf(line,false,"Display",false,"/Modes",mode.c_str()) ? cout<<"no error\n" : cout<<"error\n";
-	aug_save(aug);
-}
 
+	vector<string> inactive;
+	for(unsigned g=0;g<max(cards.size(),(size_t)1);g++){
+		unsigned i = 0;
+		while(i<list.size() && list[i].gpu!=g)
+			i++;
+		if(i==list.size())
+			continue;
+		bool anchor = g==layout.primaryGpu();
+		string driver = anchor ? driverCombo->value() : "modesetting";
+		t.beginSection(deviceFile,"Device",layout.deviceName(g));
+		t.set("Driver",driver);
+		string busId = cards.size()>1 ? Display::Layout::busId(cards[g]) : "";
+		if(!busId.empty())
+			t.set("BusID",busId);
+		else
+			t.unset("BusID");
+		vector<string> outputs;
+		for(;list.size()>1 && i<list.size();i++){
+			if(list[i].gpu!=g)
+				continue;
+			outputs.push_back("Monitor-"+layout.xorgOutput(list[i],driver));
+			t.option(outputs.back(),layout.monitorName(list[i]));
+		}
+		const Conf::Section * current = store->findSection("Device",layout.deviceName(g));
+		for(unsigned j=0;current!=NULL && j<current->entries.size();j++){
+			const Conf::Entry &e = current->entries[j];
+			if(e.kind==Conf::Entry::OPTION && !e.key.compare(0,8,"Monitor-") && find(outputs.begin(),outputs.end(),e.key)==outputs.end())
+				t.unsetOption(e.key);
+		}
+		if(!anchor){
+			inactive.push_back(layout.deviceName(g));
+			continue;
+		}
+		vector<string> known = Display::Capabilities::knownOptions();
+		for(unsigned k=0;k<known.size();k++){
+			unsigned j = find(optionNames.begin(),optionNames.end(),known[k])-optionNames.begin();
+			if(j<optionNames.size() && optionBoxes[j]->isChecked())
+				t.option(known[k],"true");
+			else
+				t.unsetOption(known[k]);
+		}
+	}
 
-bool Monitors::writeConf(string &line,bool newNode,string parameter,bool isLastParameter,string extraParam,string value){
-        string pathParam;int error;
-        pathParam.assign(line);
-        if(newNode==true){
-                pathParam.append("[last()+1]/");
-        }else{
-                pathParam.append("[last()]/");
-        }
-        pathParam.append(parameter);
-        if(isLastParameter){
-                pathParam.append("[last()+1]");
-        }else{
-                pathParam.append("[last()]");
-        }
-        pathParam.append(extraParam);
-        cout<<pathParam<<endl;
-        error = aug_set(aug,pathParam.c_str(),value.c_str());
+	t.beginSection(screenFile,"Screen","SaX3-screen");
+	t.set("Device","SaX3-device");
+	t.set("Monitor","SaX3-monitor");
+	t.set("DefaultDepth",depthCombo->value());
+	t.display("Depth",depthCombo->value());
+	t.display("Modes",list[0].mode.name);
+	if(list.size()>1){
+		char size[32];
+		sprintf(size,"%d %d",layout.virtualWidth(),layout.virtualHeight());
+		t.display("Virtual",size);
+	}else{
+		t.unsetDisplay("Virtual");
+	}
 
-        if(error==-1)
-                return false;
-        return true;
+	if(!inactive.empty() || store->findSection("ServerLayout","SaX3-layout")!=NULL){
+		t.beginSection(screenFile,"ServerLayout","SaX3-layout");
+		t.set("Screen","SaX3-screen");
+		t.setAll("Inactive",inactive);
+	}
+	if(!t.commit()){
+		cerr<<"Could not write the configuration"<<endl;
+		return false;
+	}
+	return true;
 }
 
 
@@ -7,11 +7,9 @@
 #include<libintl.h>
 #include<locale.h>
 
-extern "C"{
-#include<augeas.h>
-}
-
 #include "ui/yuifactory.h"
+#include "config/configstore.h"
+#include "config/transaction.h"
 
 #define _(STRING) gettext(STRING)
 
@@ -60,9 +58,7 @@ class Mouse{
 	string fileName,line;
 	vector<Details*> d;
 
-	augeas * aug;
-	char * root,* loadpath;
-	unsigned int flag;
+	Conf::ConfigStore * store;
 
 	UI::YUIFactory * factory;
 	UI::yDialog *dialog;
@@ -77,7 +73,6 @@ class Mouse{
 	void getProductVendor();
 	void getName();
 	void fillUpMouseList();
-	bool writeConf(string &line,bool newNode,string parameter,bool isLastParameter,string extraParam,string value);
 	void loadState();
 	void saveState();
 	public:
@@ -355,6 +350,7 @@ Mouse::~Mouse(){
 	delete hl1;
 	delete vl1;
 	delete dialog;
+	delete store;
 }
 
 void Mouse::fillUpMouseList(){
@@ -366,10 +362,9 @@ void Mouse::fillUpMouseList(){
 
 Mouse::Mouse(){
 	factory = new UI::YUIFactory();
-	aug=NULL;root=NULL;flag=0;loadpath=NULL;
 	cout<<"Loading AUgeas";
-	aug = aug_init(root,loadpath,flag);
-	if(aug==NULL){
+	store = new Conf::ConfigStore();
+	if(!store->isLoaded()){
 		cout<<"AUGEAS NOT LOADED";
 	}
 
@@ -407,109 +402,61 @@ bool Mouse::respondToEvent(){
 }
 
 bool Mouse::saveConf(){
-	char **match;int i=0,j=0,pos=0;string line,subPath,pathParam;
-	int error;
-
-	int cnt = aug_match(aug,"/files/etc/X11/xorg.conf.d/*/InputClass/*",&match);
-
-	for(i=0;i<cnt-1;i++){
-		if(strcmp(match[i],match[i+1])<0)
-			j = i;
-	}
-
-	if(cnt)
-		line.assign(match[j]);
-	else
-		line.assign("/files/etc/X11/xorg.conf.d/99-saxmouse.conf/InputClass");
-
-
-	subPath.assign("InputClass");
-	pos = line.find(subPath);
-	line.erase(pos+subPath.length(),line.size());
-	cout<<endl<<line<<endl;
+	unsigned i;
+	string file = store->sectionFile("InputClass","MatchIsPointer","on","/etc/X11/xorg.conf.d/99-saxmouse.conf");
+	cout<<endl<<file<<endl;
 
 	string Identifier = mouseList->value();
 	Identifier.append("-SaX-MouseConfig");
 	cout<<Identifier;
-	writeConf(line,true,"Identifier",false,"",Identifier.c_str()) ? cout<<"no error\n" : cout<<"error\n";
 
-	for(unsigned i=0;i<d.size();i++){
+	for(i=0;i<d.size();i++){
 		if(mouseList->value()==d[i]->getName()){
 			break;
 		}
 	}
 
-	writeConf(line,false,"MatchVendor",false,"",d[i]->getVendor().c_str()) ? cout<<"No Error\n" : cout<<"Error\n";
-	writeConf(line,false,"MatchProduct",false,"",d[i]->getProduct().c_str()) ? cout<<"No Error\n" : cout<<"Error\n";
-	writeConf(line,false,"MatchIsPointer",false,"","on") ? cout<<"No Error\n" : cout<<"Error\n";
-	writeConf(line,false,"Driver",false,"","mouse") ? cout<<"No Error\n" : cout<<"Error\n";
-	
+	Conf::Transaction t(store);
+	t.beginSection(file,"InputClass",Identifier);
+	t.set("MatchVendor",d[i]->getVendor());
+	t.set("MatchProduct",d[i]->getProduct());
+	t.set("MatchIsPointer","on");
+	t.set("Driver","mouse");
+
+	char s[12];
 	if(button3->selectedLabel()=="&Yes"){
-		writeConf(line,false,"Option",true,"","Emulate3Buttons") ? cout<<"No Error\n" : cout<<"Error\n";
-		writeConf(line,false,"Option",false,"/value","on")?cout<<"NoError\n":cout<<"Error\n";
-		writeConf(line,false,"Option",true,"","ChordMiddle") ? cout<<"No Error\n" : cout<<"Error\n";
-		writeConf(line,false,"Option",false,"/value","on")?cout<<"NoError\n":cout<<"Error\n";
-		char * s = new char[4];
+		t.option("Emulate3Buttons","on");
+		t.option("ChordMiddle","on");
 		sprintf(s,"%d",timeout->value());
-		writeConf(line,false,"Option",true,"","Emulate3Timeout") ? cout<<"No Error\n" : cout<<"Error\n";
-		writeConf(line,false,"Option",false,"/value",s)?cout<<"NoError\n":cout<<"Error\n";
-		
+		t.option("Emulate3Timeout",s);
+	}else{
+		t.unsetOption("Emulate3Buttons");
+		t.unsetOption("ChordMiddle");
+		t.unsetOption("Emulate3Timeout");
 	}
 	if(wheel->selectedLabel()=="Y&es"){
-		writeConf(line,false,"Option",true,"","EmulateWheel") ? cout<<"No Error\n" : cout<<"Error\n";
-		writeConf(line,false,"Option",false,"/value","on")?cout<<"NoError\n":cout<<"Error\n";
-		char * s = new char[4];
+		t.option("EmulateWheel","on");
 		sprintf(s,"%d",wheeltimeout->value());
-		writeConf(line,false,"Option",true,"","EmulateWheelTimeout") ? cout<<"No Error\n" : cout<<"Error\n";
-		writeConf(line,false,"Option",false,"/value",s)?cout<<"NoError\n":cout<<"Error\n";
-		
+		t.option("EmulateWheelTimeout",s);
+	}else{
+		t.unsetOption("EmulateWheel");
+		t.unsetOption("EmulateWheelTimeout");
 	}
-
-
 	if(InvX->isChecked()){
-		writeConf(line,false,"Option",true,"","InvX") ? cout<<"No Error\n" : cout<<"Error\n";
-		writeConf(line,false,"Option",false,"/value","on")?cout<<"NoError\n":cout<<"Error\n";
-	}
-	if(InvY->isChecked()){
-		writeConf(line,false,"Option",true,"","InvY") ? cout<<"No Error\n" : cout<<"Error\n";
-		writeConf(line,false,"Option",false,"/value","on")?cout<<"NoError\n":cout<<"Error\n";
-	}
-
-	char *s = new char[3];sprintf(s,"%d",AngleOffset->value());
-	writeConf(line,false,"Option",true,"","AngleOffset") ? cout<<"No Error\n" : cout<<"Error\n";
-	writeConf(line,false,"Option",false,"/value",s)?cout<<"NoError\n":cout<<"Error\n";
-	error = aug_save(aug);
-
-	if(error==-1){
-		aug_print(aug,stdout,"/augeas//error");
-		return false;
-	}
-	return true;
-}
-
-bool Mouse::writeConf(string &line,bool newNode,string parameter,bool isLastParameter,string extraParam,string value){
-	string pathParam;int error;
-	pathParam.assign(line);
-	if(newNode==true){
-		pathParam.append("[last()+1]/");
+		t.option("InvX","on");
 	}else{
-		pathParam.append("[last()]/");
+		t.unsetOption("InvX");
 	}
-	pathParam.append(parameter);
-	if(isLastParameter){
-		pathParam.append("[last()+1]");
+	if(InvY->isChecked()){
+		t.option("InvY","on");
 	}else{
-		pathParam.append("[last()]");
+		t.unsetOption("InvY");
 	}
-	pathParam.append(extraParam);
-	cout<<pathParam<<endl;
-	error = aug_set(aug,pathParam.c_str(),value.c_str());
-	
-	if(error==-1)
-		return false;
-	return true;
-}
+	sprintf(s,"%d",AngleOffset->value());
+	t.option("AngleOffset",s);
 
+	return t.commit();
+}
 
 int main(){
 	setlocale(LC_ALL,"");
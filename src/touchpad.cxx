@@ -6,11 +6,10 @@
 #include<cstdio>
 #include<locale.h>
 #include<libintl.h>
-extern "C"{
-#include<augeas.h>
-}
 
 #include "ui/yuifactory.h"
+#include "config/configstore.h"
+#include "config/transaction.h"
 
 #define _(STRING) gettext(STRING)
 #define LOG_TAG "[SaX3-Touchpad]"
@@ -19,9 +18,7 @@ using namespace std;
 
 class touchpad{
 
-	augeas * aug;
-	char * root,* loadpath;
-	unsigned int flag;
+	Conf::ConfigStore * store;
 	
 	UI::YUIFactory * factory;
 	UI::yDialog * dialog;
@@ -32,7 +29,6 @@ class touchpad{
 	UI::yPushButton * cancelButton,*okButton;
 
 	bool saveConf();
-	bool writeConf(string &line,bool newNode,string parameter,bool isLastParameter,string extraParam,string value);
 	
 	public:
 	touchpad();
@@ -43,10 +39,9 @@ class touchpad{
 
 touchpad::touchpad(){
 	factory = new UI::YUIFactory();
-	aug=NULL;root=NULL;flag=0;loadpath=NULL;
 	cout<<LOG_TAG<<"Loading Augeas"<<endl;
-	aug = aug_init(root,loadpath,flag);
-	if(aug==NULL){
+	store = new Conf::ConfigStore();
+	if(!store->isLoaded()){
 		cout<<LOG_TAG<<"AUGEAS NOT LOADED"<<endl;
 	}
 }
@@ -132,144 +127,50 @@ void touchpad::respondToEvent(){
 }
 
 bool touchpad::saveConf(){
-	char **match;int i=0,j=0,pos=0;string line,subPath,pathParam;
-	int error;
-	int cnt = aug_match(aug,"/files/etc/X11/xorg.conf.d/*/InputClass/MatchIsTouchpad",&match);
-	for(i=0;i<cnt-1;i++){
-		if(strcmp(match[i],match[i+1])<0)
-			j = i+1;
-	}
-	if(cnt)
-		line.assign(match[j]);
-	else
-		line.assign("/files/etc/X11/xorg.conf.d/99-saxtouchpad.conf/InputClass");
-
-	subPath.assign("InputClass");
-	pos = line.find(subPath);
-	line.erase(pos+subPath.length(),line.size());
-	writeConf(line,true,"Identifier",false,"","SaXTouchpadConf") ? cout<<"no error\n" : cout<<"error\n";
-	writeConf(line,false,"Driver",false,"","synaptics") ? cout<<"no error\n" : cout<<"error\n";
-	writeConf(line,false,"MatchIsTouchpad",false,"","on") ? cout<<"no error\n" : cout<<"error\n";
-
-	
-	writeConf(line,false,"Option",true,"","TapButton1") ? cout<<"no error\n" : cout<<"error\n";
-	if(TapButton1->isChecked()){
-		writeConf(line,false,"Option",false,"/value","1") ? cout<<"no error\n" : cout<<"error\n";
-	}else{
-		writeConf(line,false,"Option",false,"/value",TapButton1Click->value().c_str()) ? cout<<"no error\n" : cout<<"error\n";
-	}
-	
-	writeConf(line,false,"Option",true,"","TapButton2") ? cout<<"no error\n" : cout<<"error\n";
-	if(TapButton1->isChecked()){
-		writeConf(line,false,"Option",false,"/value","2") ? cout<<"no error\n" : cout<<"error\n";
-	}else{
-		writeConf(line,false,"Option",false,"/value",TapButton2Click->value().c_str()) ? cout<<"no error\n" : cout<<"error\n";
-	}
+	string file = store->sectionFile("InputClass","MatchIsTouchpad","on","/etc/X11/xorg.conf.d/99-saxtouchpad.conf");
 
-	
-	writeConf(line,false,"Option",true,"","TapButton3") ? cout<<"no error\n" : cout<<"error\n";
-	if(TapButton1->isChecked()){
-		writeConf(line,false,"Option",false,"/value","3") ? cout<<"no error\n" : cout<<"error\n";
-	}else{
-		writeConf(line,false,"Option",false,"/value",TapButton3Click->value().c_str()) ? cout<<"no error\n" : cout<<"error\n";
-	}
-
-	
-	writeConf(line,false,"Option",true,"","VertEdgeScroll") ? cout<<"no error\n" : cout<<"error\n";
-	if(VerticalEdgeScroll->isChecked()){
-		writeConf(line,false,"Option",false,"/value","on") ? cout<<"no error\n" : cout<<"error\n";
-	}else{
-		writeConf(line,false,"Option",false,"/value","off") ? cout<<"no error\n" : cout<<"error\n";
-	}
-
-	writeConf(line,false,"Option",true,"","HorizEdgeScroll") ? cout<<"no error\n" : cout<<"error\n";
-	if(VerticalEdgeScroll->isChecked()){
-		writeConf(line,false,"Option",false,"/value","on") ? cout<<"no error\n" : cout<<"error\n";
-	}else{
-		writeConf(line,false,"Option",false,"/value","off") ? cout<<"no error\n" : cout<<"error\n";
-	}
-
-	writeConf(line,false,"Option",true,"","VertTwoFingerScroll") ? cout<<"no error\n" : cout<<"error\n";
-	if(VerticalTwoFingerScroll->isChecked()){
-		writeConf(line,false,"Option",false,"/value","on") ? cout<<"no error\n" : cout<<"error\n";
-	}else{
-		writeConf(line,false,"Option",false,"/value","off") ? cout<<"no error\n" : cout<<"error\n";
-	}
+	Conf::Transaction t(store);
+	t.beginSection(file,"InputClass","SaXTouchpadConf");
+	t.set("Driver","synaptics");
+	t.set("MatchIsTouchpad","on");
 
+	t.option("TapButton1",TapButton1->isChecked() ? "1" : TapButton1Click->value());
+	t.option("TapButton2",TapButton1->isChecked() ? "2" : TapButton2Click->value());
+	t.option("TapButton3",TapButton1->isChecked() ? "3" : TapButton3Click->value());
+	t.option("VertEdgeScroll",VerticalEdgeScroll->isChecked() ? "on" : "off");
+	t.option("HorizEdgeScroll",VerticalEdgeScroll->isChecked() ? "on" : "off");
+	t.option("VertTwoFingerScroll",VerticalTwoFingerScroll->isChecked() ? "on" : "off");
+	t.option("HorizTwoFingerScroll",HorizontalTwoFingerScroll->isChecked() ? "on" : "off");
 
-	writeConf(line,false,"Option",true,"","HorizTwoFingerScroll") ? cout<<"no error\n" : cout<<"error\n";
-	if(HorizontalTwoFingerScroll->isChecked()){
-		writeConf(line,false,"Option",false,"/value","on") ? cout<<"no error\n" : cout<<"error\n";
-	}else{
-		writeConf(line,false,"Option",false,"/value","off") ? cout<<"no error\n" : cout<<"error\n";
-	}
-
-	writeConf(line,false,"Option",true,"","CircularScrolling") ? cout<<"no error\n" : cout<<"error\n";
 	if(CircularScroll->isChecked()){
-		writeConf(line,false,"Option",false,"/value","on") ? cout<<"no error\n" : cout<<"error\n";
-		writeConf(line,false,"Option",false,"","CircScrollTrigger") ? cout<<"no error\n" : cout<<"error\n";
-		if(!CircularLocation->value().compare("All Edges")){
-			writeConf(line,false,"Option",false,"/value","0") ? cout<<"no error\n" : cout<<"error\n";
-		}
-		if(!CircularLocation->value().compare("Top Edges")){
-			writeConf(line,false,"Option",false,"/value","1") ? cout<<"no error\n" : cout<<"error\n";
-		}
-		if(!CircularLocation->value().compare("Top Right Corner")){
-			writeConf(line,false,"Option",false,"/value","2") ? cout<<"no error\n" : cout<<"error\n";
-		}
-		if(!CircularLocation->value().compare("Right Edge ")){
-			writeConf(line,false,"Option",false,"/value","3") ? cout<<"no error\n" : cout<<"error\n";
-		}
-		if(!CircularLocation->value().compare("Bottom Right Corner")){
-			writeConf(line,false,"Option",false,"/value","4") ? cout<<"no error\n" : cout<<"error\n";
-		}
-		if(!CircularLocation->value().compare("Bottom Edge")){
-			writeConf(line,false,"Option",false,"/value","5") ? cout<<"no error\n" : cout<<"error\n";
-		}
-		if(!CircularLocation->value().compare("Bottom Left Corner")){
-			writeConf(line,false,"Option",false,"/value","6") ? cout<<"no error\n" : cout<<"error\n";
-		}
-		if(!CircularLocation->value().compare("Left Edges")){
-			writeConf(line,false,"Option",false,"/value","7") ? cout<<"no error\n" : cout<<"error\n";
-		}
-		if(!CircularLocation->value().compare("Top Left Corner")){
-			writeConf(line,false,"Option",false,"/value","8") ? cout<<"no error\n" : cout<<"error\n";
-		}
-
+		t.option("CircularScrolling","on");
+		string trigger;
+		if(!CircularLocation->value().compare("All Edges"))
+			trigger = "0";
+		if(!CircularLocation->value().compare("Top Edges"))
+			trigger = "1";
+		if(!CircularLocation->value().compare("Top Right Corner"))
+			trigger = "2";
+		if(!CircularLocation->value().compare("Right Edge "))
+			trigger = "3";
+		if(!CircularLocation->value().compare("Bottom Right Corner"))
+			trigger = "4";
+		if(!CircularLocation->value().compare("Bottom Edge"))
+			trigger = "5";
+		if(!CircularLocation->value().compare("Bottom Left Corner"))
+			trigger = "6";
+		if(!CircularLocation->value().compare("Left Edges"))
+			trigger = "7";
+		if(!CircularLocation->value().compare("Top Left Corner"))
+			trigger = "8";
+		if(!trigger.empty())
+			t.option("CircScrollTrigger",trigger);
 	}else{
-		writeConf(line,false,"Option",false,"/value","off") ? cout<<"no error\n" : cout<<"error\n";
-	}
-
-	error = aug_save(aug);
-	if(error==-1){
-		aug_print(aug,stdout,"/augeas//error");
-		return false;
+		t.option("CircularScrolling","off");
+		t.unsetOption("CircScrollTrigger");
 	}
-	return true;
-
-}
 
-bool touchpad::writeConf(string &line,bool newNode,string parameter,bool isLastParameter,string extraParam,string value){
-	string pathParam;int error;
-	pathParam.assign(line);
-	if(newNode==true){
-		pathParam.append("[last()+1]/");
-	}else{
-		pathParam.append("[last()]/");
-	}
-	pathParam.append(parameter);
-	if(isLastParameter){
-		pathParam.append("[last()+1]");
-	}else{
-		pathParam.append("[last()]");
-	}
-	pathParam.append(extraParam);
-	cout<<pathParam<<endl;
-	error = aug_set(aug,pathParam.c_str(),value.c_str());
-	
-	if(error==-1)
-		return false;
-	return true;
+	return t.commit();
 }
 
 int main(){
@@ -14,9 +14,15 @@ namespace UI{
 	class RadioButtonGroup;
 	class IntField;
 	class CheckBox;
+	class InputField;
+	class ReplacePoint;
 
 	class CheckBox{
 	};
+	class InputField{
+	};
+	class ReplacePoint{
+	};
 	class IntField{
 	};
 	class Image{
@@ -19,6 +19,7 @@ namespace UI{
 			virtual VLayout * createVLayout(HLayout *)=0;
 			virtual VLayout * createVLayout(VLayout *)=0;
 			virtual VLayout * createVLayout(Dialog *)=0;
+			virtual VLayout * createVLayout(ReplacePoint *)=0;
 			
 			virtual Label * createLabel(Dialog *,std::string) = 0;
 			virtual Label * createLabel(HLayout *,std::string) = 0;
@@ -56,6 +57,14 @@ namespace UI{
 			virtual  CheckBox * createCheckBox(VLayout *,std::string,bool)=0;
 			virtual  CheckBox * createCheckBox(Dialog *,std::string,bool)=0;
 
+			virtual  InputField * createInputField(HLayout *,std::string)=0;
+			virtual  InputField * createInputField(VLayout *,std::string)=0;
+			virtual  InputField * createInputField(Dialog *,std::string)=0;
+
+			virtual  ReplacePoint * createReplacePoint(HLayout *)=0;
+			virtual  ReplacePoint * createReplacePoint(VLayout *)=0;
+			virtual  ReplacePoint * createReplacePoint(Dialog *)=0;
+
 	};	
 	
 }
@@ -48,6 +48,10 @@ namespace UI{
 		layout = YUI::widgetFactory()->createVBox(parent->getElement());
 	}
 
+	yVLayout::yVLayout(yReplacePoint * parent){
+		layout = YUI::widgetFactory()->createVBox(parent->getElement());
+	}
+
 	YLayoutBox * yVLayout::getElement(){
 		return layout;
 	}
@@ -123,6 +127,9 @@ namespace UI{
 	void yPushButton::setEnabled(bool val){
 		button->setEnabled(val);
 	}
+	void yPushButton::setLabel(std::string text){
+		button->setLabel(text);
+	}
 
 
 	//YPUSHBUTTION FUNCTIONS END
@@ -158,6 +165,30 @@ namespace UI{
 	}
 	void yComboBox::addItem(std::string item){
 		comboBox->addItem(item);
+		/* Not a stable string, the next setItems() refills */
+		items.push_back(NULL);
+	}
+	/* The combo keeps only the pointers it was given, so the strings must
+	 * outlive it, as the descriptions of a catalogue do. Equal pointers
+	 * mean an equal entry. libyui cannot drop single items: an unchanged
+	 * list leaves the widget alone and a longer list sharing the old one
+	 * as prefix is appended. Any other change, a narrowing search
+	 * included, clears the combo and refills it in one batch. */
+	void yComboBox::setItems(const std::vector<const char *> &list){
+		size_t same = 0;
+		while(same<items.size() && same<list.size() && items[same]==list[same])
+			same++;
+		if(same==items.size() && same==list.size())
+			return;
+		if(same<items.size()){
+			comboBox->deleteAllItems();
+			same = 0;
+		}
+		YItemCollection batch;
+		for(size_t k=same;k<list.size();k++)
+			batch.push_back(new YItem(list[k]));
+		comboBox->addItems(batch);
+		items = list;
 	}
 	YComboBox * yComboBox::getElement(){
 		return comboBox;
@@ -170,6 +201,7 @@ namespace UI{
 	}
 	void yComboBox::deleteAllItems(){
 		comboBox->deleteAllItems();
+		items.clear();
 	}
 	yComboBox::~yComboBox(){
 		delete comboBox;
@@ -242,7 +274,7 @@ namespace UI{
 	}
 	void yTable::addItem(std::string item1,std::string item2){
 		table->addItem(new YTableItem(item1,item2));
-		i.push_back(std::make_pair<std::string,std::string> (item1,item2));	
+		i.push_back(std::make_pair(item1,item2));	
 	}
 	void yTable::addItem(std::string n,std::string item1,std::string item2){
 		table->addItem(new YTableItem(n,item1,item2));
@@ -430,4 +462,50 @@ namespace UI{
 	YCheckBox* yCheckBox::getElement(){
 		return cb;
 	}
+
+	//YINPUTFIELD FUNCTION STARTS
+	yInputField::yInputField(yDialog * parent,std::string text){
+		field = YUI::widgetFactory()->createInputField(parent->getElement(),text);
+		field->setNotify(true);
+	}
+	yInputField::yInputField(yHLayout * parent,std::string text){
+		field = YUI::widgetFactory()->createInputField(parent->getElement(),text);
+		field->setNotify(true);
+	}
+	yInputField::yInputField(yVLayout * parent,std::string text){
+		field = YUI::widgetFactory()->createInputField(parent->getElement(),text);
+		field->setNotify(true);
+	}
+	std::string yInputField::value(){
+		return field->value();
+	}
+	void yInputField::setValue(std::string text){
+		field->setValue(text);
+	}
+	YInputField * yInputField::getElement(){
+		return field;
+	}
+	yInputField::~yInputField(){
+		delete field;
+	}
+
+	//YREPLACEPOINT FUNCTION STARTS
+	yReplacePoint::yReplacePoint(yDialog * parent){
+		point = YUI::widgetFactory()->createReplacePoint(parent->getElement());
+	}
+	yReplacePoint::yReplacePoint(yHLayout * parent){
+		point = YUI::widgetFactory()->createReplacePoint(parent->getElement());
+	}
+	yReplacePoint::yReplacePoint(yVLayout * parent){
+		point = YUI::widgetFactory()->createReplacePoint(parent->getElement());
+	}
+	void yReplacePoint::showChild(){
+		point->showChild();
+	}
+	YReplacePoint * yReplacePoint::getElement(){
+		return point;
+	}
+	yReplacePoint::~yReplacePoint(){
+		delete point;
+	}
 }
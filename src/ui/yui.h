@@ -24,6 +24,8 @@
 #include <yui/YRadioButton.h>
 #include <yui/YIntField.h>
 #include <yui/YCheckBox.h>
+#include <yui/YInputField.h>
+#include <yui/YReplacePoint.h>
 
 #include<iostream>
 
@@ -40,6 +42,8 @@ namespace UI{
 	class yRadioButtonGroup;
 	class yIntField;
 	class yCheckBox;
+	class yInputField;
+	class yReplacePoint;
 //YUIDIALOG
 	class yDialog : public Dialog{
 		YDialog * dialog;
@@ -84,6 +88,7 @@ namespace UI{
 			yVLayout(yHLayout *);
 			yVLayout(yVLayout *);
 			yVLayout(yDialog *);
+			yVLayout(yReplacePoint *);
 			YLayoutBox * getElement();
 			~yVLayout();
 	};
@@ -107,6 +112,7 @@ namespace UI{
 		yPushButton(yVLayout *,std::string text);
 		YPushButton * getElement();
 		void setEnabled(bool);
+		void setLabel(std::string);
                 std::string value();
 		~yPushButton();
 	};
@@ -124,12 +130,14 @@ namespace UI{
 //YUICOMBOX - NON EDITABLE
 	class yComboBox : public ComboBox{
 		YComboBox * comboBox;
+		std::vector<const char *> items;
 		public:
 		yComboBox(yDialog*,std::string label);
 		yComboBox(yHLayout *,std::string label);
 		yComboBox(yVLayout *,std::string label);
 		
 		void addItem(std::string item);
+		void setItems(const std::vector<const char *> &list);
 		YComboBox * getElement();
                 std::string value();
 		void setValue(std::string&);
@@ -217,5 +225,30 @@ namespace UI{
 		YCheckBox* getElement();
 		~yCheckBox();
 	};
+
+//YINPUTFIELD - NOTIFIES ON EVERY CHANGE
+	class yInputField : public InputField{
+		YInputField * field;
+		public:
+		yInputField(yDialog*,std::string);
+		yInputField(yHLayout*,std::string);
+		yInputField(yVLayout*,std::string);
+		std::string value();
+		void setValue(std::string);
+		YInputField * getElement();
+		~yInputField();
+	};
+
+//YREPLACEPOINT - HOLDS ONE CHILD THAT CAN BE SWAPPED AT RUNTIME
+	class yReplacePoint : public ReplacePoint{
+		YReplacePoint * point;
+		public:
+		yReplacePoint(yDialog*);
+		yReplacePoint(yHLayout*);
+		yReplacePoint(yVLayout*);
+		void showChild();
+		YReplacePoint * getElement();
+		~yReplacePoint();
+	};
 }
 #endif
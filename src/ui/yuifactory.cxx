@@ -19,6 +19,9 @@ namespace UI{
 	yVLayout * YUIFactory::createVLayout(Dialog * parent){
 		return new yVLayout((yDialog*)parent);
 	}
+	yVLayout * YUIFactory::createVLayout(ReplacePoint * parent){
+		return new yVLayout((yReplacePoint*)parent);
+	}
 
 
 	yHLayout * YUIFactory::createHLayout(HLayout * parent){
@@ -121,4 +124,24 @@ namespace UI{
 	yCheckBox * YUIFactory::createCheckBox(VLayout * parent,std::string text,bool checked){
 		return new yCheckBox((yVLayout*)parent,text,checked);
 	}
+
+	yInputField * YUIFactory::createInputField(Dialog * parent,std::string text){
+		return new yInputField((yDialog*)parent,text);
+	}
+	yInputField * YUIFactory::createInputField(HLayout * parent,std::string text){
+		return new yInputField((yHLayout*)parent,text);
+	}
+	yInputField * YUIFactory::createInputField(VLayout * parent,std::string text){
+		return new yInputField((yVLayout*)parent,text);
+	}
+
+	yReplacePoint * YUIFactory::createReplacePoint(HLayout * parent){
+		return new yReplacePoint((yHLayout*)parent);
+	}
+	yReplacePoint * YUIFactory::createReplacePoint(VLayout * parent){
+		return new yReplacePoint((yVLayout*)parent);
+	}
+	yReplacePoint * YUIFactory::createReplacePoint(Dialog * parent){
+		return new yReplacePoint((yDialog*)parent);
+	}
 }
@@ -18,6 +18,7 @@ namespace UI{
 			virtual yVLayout * createVLayout(HLayout *);
 			virtual yVLayout * createVLayout(VLayout *);
 			virtual yVLayout * createVLayout(Dialog *);
+			virtual yVLayout * createVLayout(ReplacePoint *);
 
 			virtual yLabel * createLabel(Dialog *,std::string);
 			virtual yLabel * createLabel(HLayout *,std::string);
@@ -55,6 +56,14 @@ namespace UI{
 			virtual yCheckBox * createCheckBox(Dialog * parent,std::string text,bool);
 			virtual yCheckBox * createCheckBox(HLayout * parent,std::string text,bool);
 			virtual yCheckBox * createCheckBox(VLayout * parent,std::string text,bool);
+
+			virtual yInputField * createInputField(Dialog * parent,std::string text);
+			virtual yInputField * createInputField(HLayout * parent,std::string text);
+			virtual yInputField * createInputField(VLayout * parent,std::string text);
+
+			virtual yReplacePoint * createReplacePoint(HLayout * parent);
+			virtual yReplacePoint * createReplacePoint(VLayout * parent);
+			virtual yReplacePoint * createReplacePoint(Dialog * parent);
 	};	
 
 
@@ -0,0 +1,70 @@
+#include "mappedfile.h"
+
+#include<sys/mman.h>
+#include<sys/stat.h>
+#include<fcntl.h>
+#include<unistd.h>
+
+namespace Util{
+
+	MappedFile::MappedFile(){
+		buffer=NULL;length=0;modified=0;opened=false;
+	}
+
+	MappedFile::MappedFile(const std::string &path){
+		buffer=NULL;length=0;modified=0;opened=false;
+		open(path);
+	}
+
+	bool MappedFile::open(const std::string &path){
+		struct stat st;
+		close();
+		int fd = ::open(path.c_str(),O_RDONLY|O_CLOEXEC);
+		if(fd==-1)
+			return false;
+		if(fstat(fd,&st)==-1){
+			::close(fd);
+			return false;
+		}
+		length = st.st_size;
+		modified = st.st_mtime;
+		if(length>0){
+			void * p = mmap(NULL,length,PROT_READ,MAP_PRIVATE,fd,0);
+			if(p==MAP_FAILED){
+				::close(fd);
+				length=0;
+				return false;
+			}
+			buffer = (const char*)p;
+		}
+		::close(fd);
+		opened = true;
+		return true;
+	}
+
+	void MappedFile::close(){
+		if(buffer!=NULL)
+			munmap((void*)buffer,length);
+		buffer=NULL;length=0;modified=0;opened=false;
+	}
+
+	bool MappedFile::isOpen() const{
+		return opened;
+	}
+
+	const char * MappedFile::data() const{
+		return buffer;
+	}
+
+	size_t MappedFile::size() const{
+		return length;
+	}
+
+	time_t MappedFile::mtime() const{
+		return modified;
+	}
+
+	MappedFile::~MappedFile(){
+		close();
+	}
+}
@@ -0,0 +1,32 @@
+#ifndef MAPPEDFILE_H_
+#define MAPPEDFILE_H_
+
+#include<string>
+#include<sys/types.h>
+
+namespace Util{
+
+/*! \class MappedFile
+    \brief Read-only private mapping of a whole file
+    */
+	class MappedFile{
+		const char * buffer;
+		size_t length;
+		time_t modified;
+		bool opened;
+		MappedFile(const MappedFile &);
+		MappedFile & operator=(const MappedFile &);
+		public:
+		MappedFile();
+		MappedFile(const std::string &path);
+		bool open(const std::string &path);
+		void close();
+		bool isOpen() const;
+		const char * data() const;
+		size_t size() const;
+		time_t mtime() const;
+		~MappedFile();
+	};
+}
+
+#endif
@@ -0,0 +1,559 @@
+#include "catalogue.h"
+
+#include<iostream>
+#include<fstream>
+#include<algorithm>
+#include<map>
+#include<string_view>
+#include<unordered_map>
+#include<vector>
+#include<utility>
+#include<stdio.h>
+#include<stdlib.h>
+#include<string.h>
+#include<stdint.h>
+#include<time.h>
+#include<fcntl.h>
+#include<unistd.h>
+
+#define LOG_TAG "[SaX3-XKB]"
+#define RULES_FILE "/usr/share/X11/xkb/rules/base.lst"
+#define CACHE_DIR "/var/cache/sax3"
+#define CACHE_MAGIC "SAX3XKB"
+#define CACHE_VERSION 5
+#define NO_GROUP 0xffffffffu
+
+using namespace std;
+
+namespace XKB{
+
+	/* Image layout: Header, one Item array per Kind, one Table per layout
+	 * locating its run in the variant index array, the Group array, the
+	 * group number of every option, the hash tables, then the string pool.
+	 * Items hold pool offsets of NUL terminated strings, each distinct text
+	 * is stored once. Hash slots hold item index+1 with 0 for empty. */
+	struct Table{
+		uint32_t offset,count;
+	};
+
+	struct Header{
+		char magic[8];
+		uint32_t version,length;
+		int64_t sourceMtime;
+		uint64_t sourceSize;
+		Table tables[KINDS];
+		Table layoutVariants,variantIndex,groups,optionGroups;
+		Table codeHash[KINDS],descriptionHash[KINDS];
+	};
+
+	struct Item{
+		uint32_t code,description;
+	};
+
+	/* header is the option index of the group line, its options follow it
+	 * as count entries starting at first */
+	struct Group{
+		uint32_t header,first,count,exclusive;
+	};
+
+	static double now(){
+		struct timespec ts;
+		clock_gettime(CLOCK_MONOTONIC,&ts);
+		return ts.tv_sec*1000.0 + ts.tv_nsec/1000000.0;
+	}
+
+	static uint32_t hash(const char * s,size_t n){
+		uint32_t h = 2166136261u;
+		for(size_t i=0;i<n;i++){
+			h ^= (unsigned char)s[i];
+			h *= 16777619u;
+		}
+		return h;
+	}
+
+	/* Open addressing with linear probing, at most half full. Items are
+	 * inserted in table order so a lookup meets the first duplicate first. */
+	static vector<uint32_t> buildHash(const vector< pair<string,string> > &l,bool byCode){
+		size_t size = 4;
+		while(size<l.size()*2)
+			size <<= 1;
+		vector<uint32_t> slots(size,0);
+		for(unsigned i=0;i<l.size();i++){
+			const string &key = byCode ? l[i].first : l[i].second;
+			uint32_t h = hash(key.data(),key.size()) & (size-1);
+			while(slots[h]!=0)
+				h = (h+1) & (size-1);
+			slots[h] = i+1;
+		}
+		return slots;
+	}
+
+	/* base.xml sits next to base.lst and flags the option groups taking a
+	 * single choice with allowMultipleSelection="false", the default. Both
+	 * ship together, so the base.lst stamp covers it as well. */
+	static map<string,bool> exclusiveGroups(const string &rules){
+		map<string,bool> exclusive;
+		string path = rules;
+		if(path.size()>4 && !path.compare(path.size()-4,4,".lst"))
+			path.replace(path.size()-4,4,".xml");
+		Util::MappedFile xml(path);
+		if(xml.data()==NULL)
+			return exclusive;
+		string_view text(xml.data(),xml.size());
+		size_t pos = 0;
+		while((pos = text.find("<group",pos))!=string_view::npos){
+			size_t end = text.find('>',pos);
+			size_t name = text.find("<name>",pos);
+			if(end==string_view::npos || name==string_view::npos)
+				break;
+			size_t nameEnd = text.find("</name>",name);
+			if(nameEnd==string_view::npos)
+				break;
+			bool multiple = text.substr(pos,end-pos).find("allowMultipleSelection=\"true\"")!=string_view::npos;
+			exclusive[string(text.substr(name+6,nameEnd-name-6))] = !multiple;
+			pos = end;
+		}
+		return exclusive;
+	}
+
+	static bool byDescription(const pair<string,string> &a,const pair<string,string> &b){
+		return a.second<b.second;
+	}
+
+	Catalogue::Catalogue(const char * rules,const char * cacheDir){
+		base = NULL;
+		length = 0;
+		cached = full = false;
+		loadTime = 0;
+		if(cacheDir==NULL)
+			cacheDir = getenv("SAX3_CACHE_DIR");
+		rulesPath = rules!=NULL ? rules : RULES_FILE;
+		cachePath = string(cacheDir!=NULL ? cacheDir : CACHE_DIR)+"/xkb-rules.cache";
+
+		double start = now();
+		if(stat(rulesPath.c_str(),&source)==-1){
+			cerr<<LOG_TAG<<" Cannot stat "<<rulesPath<<endl;
+			return;
+		}
+		if(cache.open(cachePath) && accept(cache.data(),cache.size(),source)){
+			base = cache.data();
+			length = cache.size();
+			cached = full = true;
+		}
+		else{
+			cache.close();
+			image = compile(true);
+			base = image.empty() ? NULL : image.data();
+			length = image.size();
+		}
+		loadTime = now()-start;
+		cout<<LOG_TAG<<" "<<(cached ? "Mapped cached catalogue" : "Compiled layouts")<<" in "<<loadTime<<" ms"<<endl;
+	}
+
+	/* Compile the rest in the background, complete() picks it up. */
+	void Catalogue::prefetch(){
+		if(full || base==NULL || prefetcher.joinable())
+			return;
+		prefetcher = std::thread([this](){
+			pending = compile(false);
+			store(pending);
+		});
+	}
+
+	void Catalogue::complete(){
+		if(full || base==NULL)
+			return;
+		double start = now();
+		if(prefetcher.joinable())
+			prefetcher.join();
+		else{
+			pending = compile(false);
+			store(pending);
+		}
+		if(pending.empty())
+			return;
+		partial.swap(image);
+		image.swap(pending);
+		base = image.data();
+		length = image.size();
+		full = true;
+		cout<<LOG_TAG<<" Completed catalogue in "<<now()-start<<" ms"<<endl;
+	}
+
+	bool Catalogue::isComplete() const{
+		return full;
+	}
+
+	/* A table of count entries of the given size that lies inside the
+	 * image past the header, aligned for its entries */
+	static bool within(const Table &t,size_t entry,size_t size){
+		return t.offset>=sizeof(Header) && t.offset%4==0 && t.offset<=size && t.count<=(size-t.offset)/entry;
+	}
+
+	/* Every offset and index of the image is checked before it is used, a
+	 * truncated or damaged cache is compiled again rather than read past
+	 * its end. Strings only need to start inside the image, which ends
+	 * with the NUL of the last one. */
+	bool Catalogue::accept(const char * data,size_t size,const struct stat &st) const{
+		if(size<=sizeof(Header) || data[size-1]!=0)
+			return false;
+		const Header * h = (const Header*)data;
+		if(memcmp(h->magic,CACHE_MAGIC,8) || h->version!=CACHE_VERSION || h->length!=size ||
+				h->sourceMtime!=(int64_t)st.st_mtime || h->sourceSize!=(uint64_t)st.st_size)
+			return false;
+		for(int k=0;k<KINDS;k++){
+			if(!within(h->tables[k],sizeof(Item),size))
+				return false;
+			const Item * items = (const Item*)(data+h->tables[k].offset);
+			for(uint32_t i=0;i<h->tables[k].count;i++)
+				if(items[i].code>=size || items[i].description>=size)
+					return false;
+			const Table * hashes[] = {&h->codeHash[k],&h->descriptionHash[k]};
+			for(int j=0;j<2;j++){
+				const Table &t = *hashes[j];
+				if(!within(t,sizeof(uint32_t),size) || t.count==0 || (t.count & (t.count-1)))
+					return false;
+				const uint32_t * slots = (const uint32_t*)(data+t.offset);
+				for(uint32_t i=0;i<t.count;i++)
+					if(slots[i]>h->tables[k].count)
+						return false;
+			}
+		}
+		if(!within(h->layoutVariants,sizeof(Table),size) || h->layoutVariants.count!=h->tables[LAYOUT].count ||
+				!within(h->variantIndex,sizeof(uint32_t),size) || !within(h->groups,sizeof(Group),size) ||
+				!within(h->optionGroups,sizeof(uint32_t),size) || h->optionGroups.count!=h->tables[OPTION].count)
+			return false;
+		const Table * runs = (const Table*)(data+h->layoutVariants.offset);
+		for(uint32_t i=0;i<h->layoutVariants.count;i++)
+			if(runs[i].offset>h->variantIndex.count || runs[i].count>h->variantIndex.count-runs[i].offset)
+				return false;
+		const uint32_t * refs = (const uint32_t*)(data+h->variantIndex.offset);
+		for(uint32_t i=0;i<h->variantIndex.count;i++)
+			if(refs[i]>=h->tables[VARIANT].count)
+				return false;
+		const Group * groups = (const Group*)(data+h->groups.offset);
+		for(uint32_t i=0;i<h->groups.count;i++)
+			if(groups[i].header>=h->tables[OPTION].count || groups[i].first>h->tables[OPTION].count ||
+					groups[i].count>h->tables[OPTION].count-groups[i].first)
+				return false;
+		const uint32_t * optionGroups = (const uint32_t*)(data+h->optionGroups.offset);
+		for(uint32_t i=0;i<h->optionGroups.count;i++)
+			if(optionGroups[i]!=NO_GROUP && optionGroups[i]>=h->groups.count)
+				return false;
+		return true;
+	}
+
+	/* Parse base.lst into a fresh image. With layoutsOnly the parse stops
+	 * after the layout list and leaves the other tables empty. */
+	string Catalogue::compile(bool layoutsOnly) const{
+		ifstream in(rulesPath.c_str());
+		if(!in.is_open()){
+			cerr<<LOG_TAG<<" Cannot open "<<rulesPath<<endl;
+			return "";
+		}
+		vector< pair<string,string> > lists[KINDS];
+		int kind = -1;
+		string line;
+		while(getline(in,line)){
+			if(line.empty())
+				continue;
+			if(line[0]=='!'){
+				size_t p = line.find_first_not_of(" \t",1);
+				string name = p==string::npos ? "" : line.substr(p);
+				kind = name=="model" ? MODEL : name=="layout" ? LAYOUT : name=="variant" ? VARIANT : name=="option" ? OPTION : -1;
+				if(layoutsOnly && !lists[LAYOUT].empty())
+					break;
+				continue;
+			}
+			if(kind<0 || (layoutsOnly && kind!=LAYOUT))
+				continue;
+			size_t c = line.find_first_not_of(" \t");
+			if(c==string::npos)
+				continue;
+			/* group lines may carry a blank in the code ("Compose key"),
+			 * the description starts after a wider gap unless the code
+			 * filled its column */
+			size_t ce = line.find("  ",c);
+			if(ce==string::npos)
+				ce = line.find_first_of(" \t",c);
+			size_t d = ce==string::npos ? string::npos : line.find_first_not_of(" \t",ce);
+			if(d==string::npos)
+				continue;
+			lists[kind].push_back(make_pair(line.substr(c,ce-c),line.substr(d)));
+		}
+
+		/* the same description listed twice keeps its last code */
+		for(int k=MODEL;k<OPTION;k++){
+			vector< pair<string,string> > &l = lists[k];
+			reverse(l.begin(),l.end());
+			stable_sort(l.begin(),l.end(),byDescription);
+			vector< pair<string,string> >::iterator last = unique(l.begin(),l.end(),
+				[](const pair<string,string> &a,const pair<string,string> &b){return a.second==b.second;});
+			l.erase(last,l.end());
+		}
+
+		/* variants come as "us: Cherokee", group them under their layout */
+		multimap<string,uint32_t> byLayout;
+		for(unsigned i=0;i<lists[VARIANT].size();i++){
+			const string &d = lists[VARIANT][i].second;
+			size_t colon = d.find(':');
+			if(colon!=string::npos)
+				byLayout.insert(make_pair(d.substr(0,colon),i));
+		}
+		vector<Table> runs;
+		vector<uint32_t> refs;
+		for(unsigned i=0;i<lists[LAYOUT].size();i++){
+			Table run;
+			run.offset = refs.size();
+			pair<multimap<string,uint32_t>::iterator,multimap<string,uint32_t>::iterator> r = byLayout.equal_range(lists[LAYOUT][i].first);
+			for(;r.first!=r.second;r.first++)
+				refs.push_back(r.first->second);
+			sort(refs.begin()+run.offset,refs.end());
+			run.count = refs.size()-run.offset;
+			runs.push_back(run);
+		}
+
+		/* base.lst lists every group line right before its options, options
+		 * ahead of the first group line belong to none */
+		const vector< pair<string,string> > &options = lists[OPTION];
+		map<string,bool> exclusive = exclusiveGroups(rulesPath);
+		vector<Group> groups;
+		vector<uint32_t> optionGroups;
+		for(unsigned i=0;i<options.size();i++){
+			if(options[i].first.find(':')==string::npos){
+				Group group;
+				group.header = i;
+				group.first = i+1;
+				group.count = 0;
+				group.exclusive = exclusive.count(options[i].first) ? exclusive[options[i].first] : 0;
+				groups.push_back(group);
+			}
+			else if(!groups.empty())
+				groups.back().count++;
+			optionGroups.push_back(groups.empty() ? NO_GROUP : groups.size()-1);
+		}
+		vector<uint32_t> hashes[2][KINDS];
+		for(int k=0;k<KINDS;k++){
+			hashes[0][k] = buildHash(lists[k],true);
+			hashes[1][k] = buildHash(lists[k],false);
+		}
+
+		Header h;
+		string image;
+		memset(&h,0,sizeof(h));
+		memcpy(h.magic,CACHE_MAGIC,8);
+		h.version = CACHE_VERSION;
+		h.sourceMtime = source.st_mtime;
+		h.sourceSize = source.st_size;
+		uint32_t offset = sizeof(Header);
+		for(int k=0;k<KINDS;k++){
+			h.tables[k].offset = offset;
+			h.tables[k].count = lists[k].size();
+			offset += lists[k].size()*sizeof(Item);
+		}
+		h.layoutVariants.offset = offset;
+		h.layoutVariants.count = runs.size();
+		offset += runs.size()*sizeof(Table);
+		h.variantIndex.offset = offset;
+		h.variantIndex.count = refs.size();
+		offset += refs.size()*sizeof(uint32_t);
+		h.groups.offset = offset;
+		h.groups.count = groups.size();
+		offset += groups.size()*sizeof(Group);
+		h.optionGroups.offset = offset;
+		h.optionGroups.count = optionGroups.size();
+		offset += optionGroups.size()*sizeof(uint32_t);
+		for(int k=0;k<KINDS;k++){
+			h.codeHash[k].offset = offset;
+			h.codeHash[k].count = hashes[0][k].size();
+			offset += hashes[0][k].size()*sizeof(uint32_t);
+			h.descriptionHash[k].offset = offset;
+			h.descriptionHash[k].count = hashes[1][k].size();
+			offset += hashes[1][k].size()*sizeof(uint32_t);
+		}
+		string pool;
+		unordered_map<string,uint32_t> interned;
+		auto intern = [&](const string &text){
+			pair<unordered_map<string,uint32_t>::iterator,bool> r = interned.insert(make_pair(text,offset+pool.size()));
+			if(r.second){
+				pool.append(text);
+				pool.push_back('\0');
+			}
+			return r.first->second;
+		};
+		vector<Item> items;
+		for(int k=0;k<KINDS;k++){
+			for(unsigned i=0;i<lists[k].size();i++){
+				Item item;
+				item.code = intern(lists[k][i].first);
+				item.description = intern(lists[k][i].second);
+				items.push_back(item);
+			}
+		}
+		h.length = offset+pool.size();
+		image.assign((const char*)&h,sizeof(h));
+		image.append((const char*)items.data(),items.size()*sizeof(Item));
+		image.append((const char*)runs.data(),runs.size()*sizeof(Table));
+		image.append((const char*)refs.data(),refs.size()*sizeof(uint32_t));
+		image.append((const char*)groups.data(),groups.size()*sizeof(Group));
+		image.append((const char*)optionGroups.data(),optionGroups.size()*sizeof(uint32_t));
+		for(int k=0;k<KINDS;k++){
+			image.append((const char*)hashes[0][k].data(),hashes[0][k].size()*sizeof(uint32_t));
+			image.append((const char*)hashes[1][k].data(),hashes[1][k].size()*sizeof(uint32_t));
+		}
+		image.append(pool);
+		return image;
+	}
+
+	/* Keep a complete image for the next start. An unwritable cache
+	 * directory only costs the next start a parse. */
+	void Catalogue::store(const string &image) const{
+		if(image.empty())
+			return;
+		string dir = cachePath.substr(0,cachePath.rfind('/'));
+		mkdir(dir.c_str(),0755);
+		string tmp = cachePath+".XXXXXX";
+		vector<char> name(tmp.begin(),tmp.end());
+		name.push_back('\0');
+		int fd = mkstemp(name.data());
+		if(fd==-1)
+			return;
+		fchmod(fd,0644);
+		bool ok = write(fd,image.data(),image.size())==(ssize_t)image.size();
+		ok = close(fd)==0 && ok;
+		if(!ok || rename(name.data(),cachePath.c_str())==-1){
+			unlink(name.data());
+			cerr<<LOG_TAG<<" Cannot write "<<cachePath<<endl;
+		}
+	}
+
+	bool Catalogue::isLoaded() const{
+		return base!=NULL;
+	}
+
+	bool Catalogue::fromCache() const{
+		return cached;
+	}
+
+	double Catalogue::loadMillis() const{
+		return loadTime;
+	}
+
+	unsigned Catalogue::count(Kind kind) const{
+		return base==NULL ? 0 : ((const Header*)base)->tables[kind].count;
+	}
+
+	const char * Catalogue::code(Kind kind,unsigned i) const{
+		const Item * items = (const Item*)(base+((const Header*)base)->tables[kind].offset);
+		return base+items[i].code;
+	}
+
+	const char * Catalogue::description(Kind kind,unsigned i) const{
+		const Item * items = (const Item*)(base+((const Header*)base)->tables[kind].offset);
+		return base+items[i].description;
+	}
+
+	int Catalogue::probe(Kind kind,bool byCode,const string &key,int group) const{
+		if(base==NULL)
+			return -1;
+		const Header * h = (const Header*)base;
+		const Table &t = byCode ? h->codeHash[kind] : h->descriptionHash[kind];
+		const uint32_t * slots = (const uint32_t*)(base+t.offset);
+		uint32_t mask = t.count-1;
+		for(uint32_t i = hash(key.data(),key.size()) & mask;slots[i]!=0;i = (i+1) & mask){
+			unsigned item = slots[i]-1;
+			if(key!=(byCode ? code(kind,item) : description(kind,item)))
+				continue;
+			if(group<0 || this->group(item)==group)
+				return item;
+		}
+		return -1;
+	}
+
+	/* Option descriptions repeat across groups ("Caps Lock"), pass the group
+	 * to pick the one meant. */
+	int Catalogue::find(Kind kind,const string &description,int group) const{
+		return probe(kind,false,description,kind==OPTION ? group : -1);
+	}
+
+	int Catalogue::findCode(Kind kind,const string &code) const{
+		return probe(kind,true,code,-1);
+	}
+
+	/* Number of the group owning an option, a group line owns itself. */
+	int Catalogue::group(unsigned option) const{
+		const uint32_t * groups = (const uint32_t*)(base+((const Header*)base)->optionGroups.offset);
+		return groups[option]==NO_GROUP ? -1 : (int)groups[option];
+	}
+
+	unsigned Catalogue::groupCount() const{
+		return base==NULL ? 0 : ((const Header*)base)->groups.count;
+	}
+
+	static const Group & groupAt(const char * base,unsigned g){
+		return ((const Group*)(base+((const Header*)base)->groups.offset))[g];
+	}
+
+	unsigned Catalogue::groupHeader(unsigned g) const{
+		return groupAt(base,g).header;
+	}
+
+	/* The options of a group are the contiguous OPTION entries
+	 * first .. first+n-1. */
+	unsigned Catalogue::groupOptions(unsigned g,unsigned &n) const{
+		n = groupAt(base,g).count;
+		return groupAt(base,g).first;
+	}
+
+	bool Catalogue::exclusive(unsigned g) const{
+		return groupAt(base,g).exclusive!=0;
+	}
+
+	/* Check that no single-choice group is picked twice. On a clash the two
+	 * options are returned in first and second. */
+	bool Catalogue::validate(const vector<int> &options,int &first,int &second) const{
+		vector<int> taken(groupCount(),-1);
+		for(unsigned i=0;i<options.size();i++){
+			int g = group(options[i]);
+			if(g<0 || !exclusive(g))
+				continue;
+			if(taken[g]>=0 && taken[g]!=options[i]){
+				first = taken[g];
+				second = options[i];
+				return false;
+			}
+			taken[g] = options[i];
+		}
+		return true;
+	}
+
+	/* Indices into the VARIANT table of the variants listed for a layout,
+	 * in description order. */
+	const uint32_t * Catalogue::variants(unsigned layout,unsigned &n) const{
+		const Header * h = (const Header*)base;
+		const Table * runs = (const Table*)(base+h->layoutVariants.offset);
+		n = runs[layout].count;
+		return (const uint32_t*)(base+h->variantIndex.offset)+runs[layout].offset;
+	}
+
+	int Catalogue::findVariant(unsigned layout,const string &code) const{
+		unsigned n;
+		const uint32_t * v = variants(layout,n);
+		for(unsigned i=0;i<n;i++)
+			if(code==this->code(VARIANT,v[i]))
+				return v[i];
+		return -1;
+	}
+
+	/* The layout a variant is listed under, from its "us: " prefix. */
+	int Catalogue::layoutOf(unsigned variant) const{
+		const char * d = description(VARIANT,variant);
+		const char * colon = strchr(d,':');
+		return colon==NULL ? -1 : findCode(LAYOUT,string(d,colon-d));
+	}
+
+	Catalogue::~Catalogue(){
+		if(prefetcher.joinable())
+			prefetcher.join();
+	}
+}
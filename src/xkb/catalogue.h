@@ -0,0 +1,75 @@
+#ifndef CATALOGUE_H_
+#define CATALOGUE_H_
+
+#include "../util/mappedfile.h"
+
+#include<string>
+#include<thread>
+#include<vector>
+#include<stdint.h>
+#include<sys/stat.h>
+
+namespace XKB{
+
+	enum Kind{MODEL,LAYOUT,VARIANT,OPTION,KINDS};
+
+/*! \class Catalogue
+    \brief Models, layouts, variants and options from the XKB rules list
+
+    base.lst is compiled once into a flat image kept in SAX3_CACHE_DIR
+    (/var/cache/sax3 by default) and mapped on later starts. The image records
+    mtime and size of the list it came from and is rebuilt once those change.
+    Models, layouts and variants are sorted by description. Options are laid
+    out group by group, each group line directly followed by its options, and
+    groups that take a single option are marked exclusive.
+    Each layout also owns the slice of variant indices listed for its code.
+    Codes and descriptions of every kind resolve through hash tables stored
+    in the image, and each option records the group it belongs to.
+
+    Without a usable cache only the layouts are compiled up front. Models,
+    variants and options follow on complete(), or earlier on a background
+    thread started by prefetch(). Layout indices stay the same across both.
+    */
+	class Catalogue{
+		Util::MappedFile cache;
+		std::string image,partial,pending;
+		const char * base;
+		size_t length;
+		std::string rulesPath,cachePath;
+		struct stat source;
+		bool cached,full;
+		double loadTime;
+		std::thread prefetcher;
+		bool accept(const char * data,size_t size,const struct stat &st) const;
+		std::string compile(bool layoutsOnly) const;
+		void store(const std::string &data) const;
+		Catalogue(const Catalogue &);
+		Catalogue & operator=(const Catalogue &);
+		int probe(Kind kind,bool byCode,const std::string &key,int group) const;
+		public:
+		Catalogue(const char * rules=NULL,const char * cacheDir=NULL);
+		void prefetch();
+		void complete();
+		bool isComplete() const;
+		bool isLoaded() const;
+		bool fromCache() const;
+		double loadMillis() const;
+		unsigned count(Kind kind) const;
+		const char * code(Kind kind,unsigned i) const;
+		const char * description(Kind kind,unsigned i) const;
+		int find(Kind kind,const std::string &description,int group=-1) const;
+		int findCode(Kind kind,const std::string &code) const;
+		int group(unsigned option) const;
+		unsigned groupCount() const;
+		unsigned groupHeader(unsigned g) const;
+		unsigned groupOptions(unsigned g,unsigned &n) const;
+		bool exclusive(unsigned g) const;
+		bool validate(const std::vector<int> &options,int &first,int &second) const;
+		const uint32_t * variants(unsigned layout,unsigned &n) const;
+		int findVariant(unsigned layout,const std::string &code) const;
+		int layoutOf(unsigned variant) const;
+		~Catalogue();
+	};
+}
+
+#endif
@@ -0,0 +1,158 @@
+#include "localeindex.h"
+
+#include<iostream>
+#include<ctype.h>
+#include<unistd.h>
+
+#define LOG_TAG "[SaX3-XKB]"
+#define EVDEV_XML "/usr/share/X11/xkb/rules/evdev.xml"
+#define BASE_XML "/usr/share/X11/xkb/rules/base.xml"
+
+using namespace std;
+
+namespace XKB{
+
+	static const vector<LayoutRef> none;
+
+	bool LocaleIndex::load(const char * file){
+		string xml = file!=NULL ? file : access(EVDEV_XML,R_OK)==0 ? EVDEV_XML : BASE_XML;
+		languages.clear();
+		countries.clear();
+		aliases.clear();
+		depth = 0;
+		layout.clear();
+		layoutsDone = false;
+		XmlReader reader(this);
+		if(!reader.parse(xml)){
+			cerr<<LOG_TAG<<" Cannot read "<<xml<<endl;
+			return false;
+		}
+		return true;
+	}
+
+	void LocaleIndex::add(map< string,vector<LayoutRef> > &index,const string &key,const LayoutRef &ref){
+		vector<LayoutRef> &list = index[key];
+		for(unsigned i=0;i<list.size();i++)
+			if(list[i].layout==ref.layout && list[i].variant==ref.variant)
+				return;
+		list.push_back(ref);
+	}
+
+	void LocaleIndex::startElement(const string &element,const string &){
+		/* Entries above depth are kept to reuse their storage */
+		if(depth==path.size())
+			path.push_back(element);
+		else
+			path[depth] = element;
+		depth++;
+		text.clear();
+		if(element=="configItem"){
+			name.clear();
+			shortName.clear();
+			itemLanguages.clear();
+			itemCountries.clear();
+		}
+	}
+
+	/* Only configItems of a layout or a variant matter, option groups carry
+	 * no locale data. */
+	void LocaleIndex::endElement(const string &element){
+		static const string noParent;
+		const string &parent = depth>=2 ? path[depth-2] : noParent;
+		if(element=="name" && parent=="configItem")
+			name = text;
+		else if(element=="shortDescription" && parent=="configItem")
+			shortName = text;
+		else if(element=="iso639Id")
+			itemLanguages.push_back(text);
+		else if(element=="iso3166Id")
+			itemCountries.push_back(text);
+		else if(element=="configItem" && (parent=="layout" || parent=="variant")){
+			LayoutRef ref;
+			if(parent=="layout")
+				layout = name;
+			ref.layout = layout;
+			if(parent=="variant")
+				ref.variant = name;
+			for(unsigned i=0;i<itemLanguages.size();i++)
+				add(languages,itemLanguages[i],ref);
+			for(unsigned i=0;i<itemCountries.size();i++)
+				add(countries,itemCountries[i],ref);
+			if(itemLanguages.size()==1 && shortName.size()==2 && !aliases.count(shortName))
+				aliases[shortName] = itemLanguages[0];
+		}
+		else if(element=="layoutList")
+			layoutsDone = true;
+		if(depth>0)
+			depth--;
+		text.clear();
+	}
+
+	bool LocaleIndex::finished() const{
+		return layoutsDone;
+	}
+
+	void LocaleIndex::characters(const string &chars){
+		text += chars;
+	}
+
+	const vector<LayoutRef> & LocaleIndex::byLanguage(const string &iso639) const{
+		map< string,vector<LayoutRef> >::const_iterator it = languages.find(iso639);
+		return it==languages.end() ? none : it->second;
+	}
+
+	const vector<LayoutRef> & LocaleIndex::byCountry(const string &iso3166) const{
+		map< string,vector<LayoutRef> >::const_iterator it = countries.find(iso3166);
+		return it==countries.end() ? none : it->second;
+	}
+
+	/* Likely layouts for a locale name like de_CH.UTF-8: those listed for
+	 * both language and country, then the rest of the country's, then the
+	 * rest of the language's. Plain layouts go before variants. */
+	void LocaleIndex::suggest(const string &locale,vector<LayoutRef> &out) const{
+		out.clear();
+		size_t end = locale.find_first_of(".@");
+		string id = locale.substr(0,end);
+		size_t sep = id.find('_');
+		string lang = id.substr(0,sep);
+		string country = sep==string::npos ? "" : id.substr(sep+1);
+		for(unsigned i=0;i<lang.size();i++)
+			lang[i] = tolower((unsigned char)lang[i]);
+		map<string,string>::const_iterator a = aliases.find(lang);
+		if(a!=aliases.end())
+			lang = a->second;
+
+		const vector<LayoutRef> &byLang = byLanguage(lang),&byCtry = byCountry(country);
+		vector<LayoutRef> ranked;
+		for(int pass=0;pass<3;pass++){
+			const vector<LayoutRef> &list = pass==2 ? byLang : byCtry;
+			for(unsigned i=0;i<list.size();i++){
+				bool inLang=false;
+				for(unsigned j=0;pass==0 && j<byLang.size() && !inLang;j++)
+					inLang = byLang[j].layout==list[i].layout && byLang[j].variant==list[i].variant;
+				if(pass==0 && !inLang)
+					continue;
+				ranked.push_back(list[i]);
+			}
+		}
+		for(int variants=0;variants<2;variants++){
+			for(unsigned i=0;i<ranked.size();i++){
+				if(ranked[i].variant.empty()==(variants==1))
+					continue;
+				bool seen=false;
+				for(unsigned j=0;j<out.size() && !seen;j++)
+					seen = out[j].layout==ranked[i].layout && out[j].variant==ranked[i].variant;
+				if(!seen)
+					out.push_back(ranked[i]);
+			}
+		}
+	}
+
+	size_t LocaleIndex::languageCount() const{
+		return languages.size();
+	}
+
+	size_t LocaleIndex::countryCount() const{
+		return countries.size();
+	}
+}
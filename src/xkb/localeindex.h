@@ -0,0 +1,49 @@
+#ifndef LOCALEINDEX_H_
+#define LOCALEINDEX_H_
+
+#include "xmlreader.h"
+
+#include<map>
+#include<string>
+#include<vector>
+
+namespace XKB{
+
+	struct LayoutRef{
+		std::string layout,variant;
+	};
+
+/*! \class LocaleIndex
+    \brief Layouts and variants by ISO 639 language and ISO 3166 country
+
+    Filled in one streaming pass over evdev.xml (base.xml when missing). The
+    two letter indicator a layout shows next to a single language id is kept
+    as an alias, which lets a POSIX locale name such as de_DE.UTF-8 be
+    mapped onto the three letter ids the rules use. Only the layout list
+    carries locale data, the pass ends with it and never reads the option
+    list that makes up most of the file.
+    */
+	class LocaleIndex : public XmlHandler{
+		std::map< std::string,std::vector<LayoutRef> > languages,countries;
+		std::map<std::string,std::string> aliases;
+		std::vector<std::string> path;
+		size_t depth;
+		std::string text,name,shortName,layout;
+		std::vector<std::string> itemLanguages,itemCountries;
+		bool layoutsDone;
+		void add(std::map< std::string,std::vector<LayoutRef> > &index,const std::string &key,const LayoutRef &ref);
+		public:
+		bool load(const char * file=NULL);
+		const std::vector<LayoutRef> & byLanguage(const std::string &iso639) const;
+		const std::vector<LayoutRef> & byCountry(const std::string &iso3166) const;
+		void suggest(const std::string &locale,std::vector<LayoutRef> &out) const;
+		size_t languageCount() const;
+		size_t countryCount() const;
+		void startElement(const std::string &name,const std::string &attributes);
+		void endElement(const std::string &name);
+		void characters(const std::string &text);
+		bool finished() const;
+	};
+}
+
+#endif
@@ -0,0 +1,105 @@
+#include "search.h"
+
+#include<algorithm>
+#include<ctype.h>
+#include<string.h>
+
+using namespace std;
+
+namespace XKB{
+
+	enum{FUZZY=1,SUBSTRING,PREFIX,CODE};
+
+	static string lower(const string &s){
+		string l(s);
+		for(unsigned i=0;i<l.size();i++)
+			l[i] = tolower((unsigned char)l[i]);
+		return l;
+	}
+
+	static uint32_t trigram(const char * p){
+		return (unsigned char)p[0]<<16 | (unsigned char)p[1]<<8 | (unsigned char)p[2];
+	}
+
+	/* Texts are "code\ndescription", lower case. Words are the whole code
+	 * plus every alphanumeric run, so "caps:escape" is found by "caps",
+	 * "escape" and itself. */
+	Search::Search(const Catalogue * catalogue){
+		for(int k=0;k<KINDS;k++){
+			for(unsigned i=0;i<catalogue->count((Kind)k);i++){
+				Match m;
+				m.kind = (Kind)k;
+				m.item = i;
+				entries.push_back(m);
+				texts.push_back(lower(catalogue->code(m.kind,i))+"\n"+lower(catalogue->description(m.kind,i)));
+			}
+		}
+		for(uint32_t e=0;e<texts.size();e++){
+			string_view t = texts[e];
+			words.push_back(make_pair(t.substr(0,t.find('\n')),e));
+			for(size_t p=0;p<t.size();){
+				while(p<t.size() && !isalnum((unsigned char)t[p]))
+					p++;
+				size_t w = p;
+				while(p<t.size() && isalnum((unsigned char)t[p]))
+					p++;
+				if(p>w)
+					words.push_back(make_pair(t.substr(w,p-w),e));
+			}
+			for(size_t p=0;p+3<=t.size();p++){
+				vector<uint32_t> &list = trigrams[trigram(t.data()+p)];
+				if(list.empty() || list.back()!=e)
+					list.push_back(e);
+			}
+		}
+		sort(words.begin(),words.end());
+	}
+
+	void Search::find(const string &query,vector<Match> &hits) const{
+		hits.clear();
+		string q = lower(query);
+		size_t b = q.find_first_not_of(" \t"),e = q.find_last_not_of(" \t");
+		if(b==string::npos)
+			return;
+		q = q.substr(b,e-b+1);
+
+		vector<unsigned char> score(entries.size(),0);
+		vector< pair<string_view,uint32_t> >::const_iterator w;
+		w = lower_bound(words.begin(),words.end(),make_pair(string_view(q),(uint32_t)0));
+		for(;w!=words.end() && !w->first.compare(0,q.size(),q);w++)
+			score[w->second] = PREFIX;
+
+		if(q.size()>=3){
+			vector<uint32_t> grams;
+			for(size_t p=0;p+3<=q.size();p++)
+				grams.push_back(trigram(q.data()+p));
+			sort(grams.begin(),grams.end());
+			grams.erase(unique(grams.begin(),grams.end()),grams.end());
+			vector<unsigned short> shared(entries.size(),0);
+			for(unsigned g=0;g<grams.size();g++){
+				unordered_map< uint32_t,vector<uint32_t> >::const_iterator it = trigrams.find(grams[g]);
+				if(it==trigrams.end())
+					continue;
+				for(unsigned k=0;k<it->second.size();k++)
+					shared[it->second[k]]++;
+			}
+			for(uint32_t i=0;i<entries.size();i++){
+				if(shared[i]==grams.size() && score[i]<SUBSTRING && texts[i].find(q)!=string::npos)
+					score[i] = SUBSTRING;
+				else if(!score[i] && grams.size()>=2 && shared[i]*3>=grams.size()*2)
+					score[i] = FUZZY;
+			}
+		}
+		for(uint32_t i=0;i<entries.size();i++)
+			if(score[i] && !texts[i].compare(0,texts[i].find('\n'),q))
+				score[i] = CODE;
+
+		vector< pair<int,uint32_t> > ranked;
+		for(uint32_t i=0;i<entries.size();i++)
+			if(score[i])
+				ranked.push_back(make_pair(-score[i],i));
+		sort(ranked.begin(),ranked.end());
+		for(unsigned i=0;i<ranked.size();i++)
+			hits.push_back(entries[ranked[i].second]);
+	}
+}
@@ -0,0 +1,39 @@
+#ifndef SEARCH_H_
+#define SEARCH_H_
+
+#include "catalogue.h"
+
+#include<string>
+#include<string_view>
+#include<unordered_map>
+#include<utility>
+#include<vector>
+
+namespace XKB{
+
+	struct Match{
+		Kind kind;
+		unsigned item;
+	};
+
+/*! \class Search
+    \brief Type-ahead lookup over the codes and descriptions of a Catalogue
+
+    Queries shorter than three characters go to a sorted word prefix index,
+    longer ones to a trigram index whose candidates are checked for the
+    query as a substring. Entries sharing two thirds of the query trigrams
+    are returned as fuzzy matches after the exact ones. Matching ignores case.
+    The catalogue has to be complete() before the index is built.
+    */
+	class Search{
+		std::vector<Match> entries;
+		std::vector<std::string> texts;
+		std::unordered_map< uint32_t,std::vector<uint32_t> > trigrams;
+		std::vector< std::pair<std::string_view,uint32_t> > words;
+		public:
+		Search(const Catalogue * catalogue);
+		void find(const std::string &query,std::vector<Match> &hits) const;
+	};
+}
+
+#endif
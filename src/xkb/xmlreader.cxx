@@ -0,0 +1,142 @@
+#include "xmlreader.h"
+
+#include "../util/mappedfile.h"
+
+#include<string.h>
+
+using namespace std;
+
+namespace XKB{
+
+	static inline bool blank(char c){
+		return c==' ' || c=='\t' || c=='\r' || c=='\n';
+	}
+
+	/* Replace the predefined entities of s[begin,end) into out, reusing its
+	 * storage */
+	static void decode(const string &s,size_t begin,size_t end,string &out){
+		static const char * names[] = {"&lt;","&gt;","&amp;","&quot;","&apos;"};
+		static const char chars[] = {'<','>','&','"','\''};
+		out.assign(s,begin,end-begin);
+		if(out.find('&')==string::npos)
+			return;
+		string in;
+		in.swap(out);
+		for(size_t i=0;i<in.size();i++){
+			int e=0;
+			if(in[i]=='&')
+				while(e<5 && in.compare(i,strlen(names[e]),names[e]))
+					e++;
+			if(in[i]!='&' || e==5){
+				out.push_back(in[i]);
+				continue;
+			}
+			out.push_back(chars[e]);
+			i += strlen(names[e])-1;
+		}
+	}
+
+	XmlReader::XmlReader(XmlHandler * handler){
+		this->handler = handler;
+	}
+
+	void XmlReader::flushText(){
+		size_t b=0,e=text.size();
+		while(b<e && blank(text[b]))
+			b++;
+		while(e>b && blank(text[e-1]))
+			e--;
+		if(b<e){
+			decode(text,b,e,value);
+			handler->characters(value);
+		}
+		text.clear();
+	}
+
+	void XmlReader::flushTag(){
+		if(tag.empty() || tag[0]=='?' || tag[0]=='!')
+			return;
+		size_t e = tag[0]=='/' ? 1 : 0;
+		while(e<tag.size() && !blank(tag[e]) && tag[e]!='/')
+			e++;
+		if(tag[0]=='/'){
+			name.assign(tag,1,e-1);
+			handler->endElement(name);
+			return;
+		}
+		bool empty = tag[tag.size()-1]=='/';
+		size_t end = empty ? tag.size()-1 : tag.size();
+		name.assign(tag,0,e);
+		if(e<end)
+			decode(tag,e+1,end,value);
+		else
+			value.clear();
+		handler->startElement(name,value);
+		if(empty)
+			handler->endElement(name);
+	}
+
+	bool XmlReader::parse(const string &path){
+		Util::MappedFile file;
+		if(!file.open(path))
+			return false;
+		const char * data = file.data();
+		size_t n = file.size();
+		bool inTag=false,comment=false;
+		char quote=0;
+		tag.clear();
+		text.clear();
+		for(size_t i=0;i<n;i++){
+			char c = data[i];
+			if(!inTag){
+				/* Copy the whole run up to the next tag at once */
+				const char * lt = (const char *)memchr(data+i,'<',n-i);
+				size_t end = lt==NULL ? n : lt-data;
+				text.append(data+i,end-i);
+				if(lt==NULL)
+					break;
+				i = end;
+				flushText();
+				inTag = true;
+				comment = false;
+				quote = 0;
+				tag.clear();
+				continue;
+			}
+			if(comment){
+				tag.push_back(c);
+				if(c=='>' && tag.size()>=5 && !tag.compare(tag.size()-3,3,"-->"))
+					inTag = false;
+				continue;
+			}
+			if(quote){
+				if(c==quote)
+					quote = 0;
+				tag.push_back(c);
+				continue;
+			}
+			if(c=='"' || c=='\''){
+				quote = c;
+				tag.push_back(c);
+				continue;
+			}
+			if(c=='>'){
+				flushTag();
+				inTag = false;
+				if(handler->finished())
+					return true;
+				continue;
+			}
+			/* Plain tag characters up to the next quote or end of tag */
+			size_t end = i;
+			while(end<n && data[end]!='>' && data[end]!='"' && data[end]!='\'')
+				end++;
+			tag.append(data+i,end-i);
+			i = end-1;
+			if(tag.size()>=3 && !tag.compare(0,3,"!--"))
+				comment = true;
+		}
+		flushText();
+		return !inTag;
+	}
+}
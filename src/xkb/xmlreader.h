@@ -0,0 +1,43 @@
+#ifndef XMLREADER_H_
+#define XMLREADER_H_
+
+#include<string>
+
+namespace XKB{
+
+/*! \class XmlHandler
+    \brief Receives the events of an XmlReader pass
+
+    A handler that has what it needs returns true from finished() and the
+    reader stops there instead of reading the rest of the file.
+    */
+	class XmlHandler{
+		public:
+		virtual void startElement(const std::string &name,const std::string &attributes)=0;
+		virtual void endElement(const std::string &name)=0;
+		virtual void characters(const std::string &text)=0;
+		virtual bool finished() const{ return false; }
+		virtual ~XmlHandler(){}
+	};
+
+/*! \class XmlReader
+    \brief Streaming reader for the xkeyboard-config rule files
+
+    Maps the file and reports elements and text as it goes, nothing but the
+    current tag and text run is copied out of the mapping. It knows as much XML
+    as the rules files use: elements, attributes, comments, declarations and
+    the five predefined entities. Text is passed on trimmed, blank runs
+    between elements are dropped.
+    */
+	class XmlReader{
+		XmlHandler * handler;
+		std::string tag,text,name,value;
+		void flushText();
+		void flushTag();
+		public:
+		XmlReader(XmlHandler * handler);
+		bool parse(const std::string &path);
+	};
+}
+
+#endif